@@ -0,0 +1,728 @@
+// Native benchmarks for the engine-independent core in src/core/.
+//
+// Build with `scons bench` and run bin/gdcraft-bench. Every benchmark runs on
+// three standard terrains (a flat plain, noise hills with caves, and a 3D
+// checkerboard, the worst case for meshing) in a 3x3 grid of linked chunks,
+// and reports the best of several rounds. Terrain generation and cave culling,
+// which make their own chunks, are measured once before them. Pass --csv for machine-readable
+// output to compare against earlier runs.
+//
+// Heap allocations are counted too: steady-state meshing must not allocate, and
+// the benchmark exits with an error if it does. It does the same if the greedy
+// mesher covers different faces than the naive one, if cave culling reaches
+// other sections than expected in a fixed cave layout, or if chunk snapshots
+// or deltas fail to reproduce the blocks they encode.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/chunk_codec.h"
+#include "core/chunk_data.h"
+#include "core/light_engine.h"
+#include "core/noise.h"
+#include "core/section_visibility.h"
+#include "core/terrain_column.h"
+#include "core/voxel_mesher.h"
+#include "core/voxel_raycaster.h"
+
+using namespace godot;
+
+// Every global allocation goes through here, so a benchmark can count them.
+// GCC mistakes the malloc/free pairs below for mismatched new/free once they
+// are inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<int64_t> allocation_count{ 0 };
+
+void *operator new(std::size_t p_size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p_memory = std::malloc(p_size != 0 ? p_size : 1)) {
+        return p_memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t p_size) {
+    return operator new(p_size);
+}
+
+void operator delete(void *p_memory) noexcept {
+    std::free(p_memory);
+}
+
+void operator delete[](void *p_memory) noexcept {
+    std::free(p_memory);
+}
+
+void operator delete(void *p_memory, std::size_t) noexcept {
+    operator delete(p_memory);
+}
+
+void operator delete[](void *p_memory, std::size_t) noexcept {
+    operator delete[](p_memory);
+}
+
+static const int32_t GRID = 3; // chunks per side; the centre chunk is measured
+static const int32_t ROUNDS = 5;
+
+static const int32_t STONE = 1;
+static const int32_t DIRT = 2;
+static const int32_t GRASS = 3;
+
+struct Scenario {
+    std::string name;
+    std::vector<std::unique_ptr<GDC_ChunkData>> chunks; // GRID * GRID, x-major
+
+    GDC_ChunkData &get(int32_t x, int32_t z) { return *chunks[x * GRID + z]; }
+    GDC_ChunkData &centre() { return get(GRID / 2, GRID / 2); }
+    GDC_ChunkData *find(int32_t x, int32_t z) {
+        return x >= 0 && z >= 0 && x < GRID && z < GRID ? &get(x, z) : nullptr;
+    }
+};
+
+struct Result {
+    double ns_per_op = 0.0;
+    double vertices_per_second = 0.0;
+    double chunks_per_second = 0.0;
+    double allocations_per_op = -1.0; // after the timed warm-up rounds; < 0 when not measured
+    double bytes_per_op = -1.0; // encoded size; < 0 when not measured
+    bool failed = false; // the benchmark's own correctness check did not hold
+};
+
+// Scattered glowstone underground, so block light gets exercised too.
+static const int32_t GLOWSTONE = 4;
+
+// Ids 1-4 as the world's registry would compile them: opaque, solid cubes.
+static GDC_BlockTable make_block_table() {
+    GDC_BlockTable blocks;
+    blocks.reset(GLOWSTONE + 1);
+    blocks.set_block(GLOWSTONE, GDC_BlockTable::RENDER_LAYER_OPAQUE, true, 14);
+    blocks.build_face_culling();
+    return blocks;
+}
+static const GDC_BlockTable BLOCKS = make_block_table();
+
+static const GDC_ChunkData *find_chunk(int32_t x, int32_t z, const void *p_userdata) {
+    return static_cast<Scenario *>(const_cast<void *>(p_userdata))->find(x, z);
+}
+
+static void link_chunks(Scenario &r_scenario) {
+    for (int32_t x = 0; x < GRID; ++x) {
+        for (int32_t z = 0; z < GRID; ++z) {
+            GDC_ChunkData &chunk = r_scenario.get(x, z);
+            chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_PX, r_scenario.find(x + 1, z));
+            chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_NX, r_scenario.find(x - 1, z));
+            chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_PZ, r_scenario.find(x, z + 1));
+            chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_NZ, r_scenario.find(x, z - 1));
+        }
+    }
+    for (const std::unique_ptr<GDC_ChunkData> &chunk : r_scenario.chunks) {
+        GDC_LightEngine::light_chunk(*chunk, BLOCKS);
+    }
+    for (const std::unique_ptr<GDC_ChunkData> &chunk : r_scenario.chunks) {
+        GDC_LightEngine::stitch_chunk(*chunk, BLOCKS);
+    }
+}
+
+static Scenario make_scenario(const std::string &p_name, const std::function<int32_t(int32_t, int32_t, int32_t)> &p_block) {
+    constexpr int32_t SIZE = GDC_ChunkData::SIZE;
+    Scenario scenario;
+    scenario.name = p_name;
+
+    std::vector<int32_t> ids(GDC_ChunkData::BLOCK_COUNT);
+    for (int32_t cx = 0; cx < GRID; ++cx) {
+        for (int32_t cz = 0; cz < GRID; ++cz) {
+            for (int32_t y = 0; y < GDC_ChunkData::HEIGHT; ++y) {
+                for (int32_t z = 0; z < SIZE; ++z) {
+                    for (int32_t x = 0; x < SIZE; ++x) {
+                        ids[(y * SIZE + z) * SIZE + x] = p_block(cx * SIZE + x, y, cz * SIZE + z);
+                    }
+                }
+            }
+            scenario.chunks.push_back(std::make_unique<GDC_ChunkData>());
+            scenario.chunks.back()->load_blocks(ids.data());
+        }
+    }
+    link_chunks(scenario);
+    return scenario;
+}
+
+static Scenario make_flat() {
+    return make_scenario("flat", [](int32_t, int32_t y, int32_t) {
+        return y < 60 ? STONE : (y < 63 ? DIRT : (y == 63 ? GRASS : 0));
+    });
+}
+
+static Scenario make_noise() {
+    const GDC_Noise noise(1337);
+    return make_scenario("noise", [&noise](int32_t x, int32_t y, int32_t z) {
+        const int32_t height = 64 + static_cast<int32_t>(noise.sample_2d(x * 0.02f, z * 0.02f) * 24.0f);
+        if (y > height) { return 0; }
+        if (y > 4 && noise.sample_3d(x * 0.08f, y * 0.08f, z * 0.08f) > 0.35f) { return 0; } // caves
+        if (y < height - 4 && (x * 31 + y * 17 + z * 7) % 97 == 0) { return GLOWSTONE; }
+        return y == height ? GRASS : (y > height - 4 ? DIRT : STONE);
+    });
+}
+
+static Scenario make_checkerboard() {
+    return make_scenario("checkerboard", [](int32_t x, int32_t y, int32_t z) {
+        return ((x + y + z) & 1) != 0 ? STONE : 0;
+    });
+}
+
+// Best of ROUNDS runs of `p_run`, which performs `ops` operations.
+template <typename F>
+static double time_ns_per_op(int64_t ops, F &&p_run) {
+    double best = 1e300;
+    for (int32_t round = 0; round < ROUNDS; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        p_run();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops));
+    }
+    return best;
+}
+
+// Heap allocations made by one more run of `p_run`, per operation.
+template <typename F>
+static double count_allocations_per_op(int64_t ops, F &&p_run) {
+    const int64_t before = allocation_count.load(std::memory_order_relaxed);
+    p_run();
+    return static_cast<double>(allocation_count.load(std::memory_order_relaxed) - before) / static_cast<double>(ops);
+}
+
+// Keeps results alive so the optimiser cannot drop the measured work.
+static volatile int64_t sink = 0;
+
+static Result bench_get_block(Scenario &r_scenario) {
+    constexpr int32_t OPS = 1 << 20;
+    std::mt19937 rng(1);
+    std::vector<int32_t> coords(OPS);
+    for (int32_t &coord : coords) {
+        coord = static_cast<int32_t>(rng() % GDC_ChunkData::BLOCK_COUNT);
+    }
+
+    const GDC_ChunkData &chunk = r_scenario.centre();
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        int64_t total = 0;
+        for (int32_t index : coords) {
+            total += chunk.get_block(index % 16, index / 256, (index / 16) % 16);
+        }
+        sink = sink + total;
+    });
+    return result;
+}
+
+static Result bench_set_block(Scenario &r_scenario) {
+    constexpr int32_t OPS = 1 << 18;
+    std::mt19937 rng(2);
+    std::vector<int32_t> coords(OPS);
+    for (int32_t &coord : coords) {
+        coord = static_cast<int32_t>(rng() % GDC_ChunkData::BLOCK_COUNT);
+    }
+
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        GDC_ChunkData chunk = r_scenario.centre();
+        for (int32_t i = 0; i < OPS; ++i) {
+            const int32_t index = coords[i];
+            chunk.set_block(index % 16, index / 256, (index / 16) % 16, (i & 3) == 0 ? 0 : 1 + (i & 3));
+        }
+        sink = sink + chunk.get_palette_size();
+    });
+    return result;
+}
+
+static Result bench_fill_range(Scenario &r_scenario) {
+    constexpr int32_t OPS = 1 << 12;
+    std::mt19937 rng(3);
+    std::vector<std::array<int32_t, 6>> boxes(OPS);
+    for (std::array<int32_t, 6> &box : boxes) {
+        box[0] = static_cast<int32_t>(rng() % 16);
+        box[1] = static_cast<int32_t>(rng() % 128);
+        box[2] = static_cast<int32_t>(rng() % 16);
+        box[3] = box[0] + 1 + static_cast<int32_t>(rng() % 8);
+        box[4] = box[1] + 1 + static_cast<int32_t>(rng() % 8);
+        box[5] = box[2] + 1 + static_cast<int32_t>(rng() % 8);
+    }
+
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        GDC_ChunkData chunk = r_scenario.centre();
+        for (int32_t i = 0; i < OPS; ++i) {
+            const std::array<int32_t, 6> &box = boxes[i];
+            sink = sink + chunk.fill_range(box[0], box[1], box[2], box[3], box[4], box[5], i % 4);
+        }
+    });
+    return result;
+}
+
+// One op is lighting one chunk on its own, as streaming does on a worker.
+static Result bench_light_chunk(Scenario &r_scenario) {
+    constexpr int32_t OPS = 16;
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        GDC_ChunkData chunk = r_scenario.centre();
+        chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_PX, nullptr);
+        chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_NX, nullptr);
+        chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_PZ, nullptr);
+        chunk.set_neighbour(GDC_ChunkData::NEIGHBOUR_NZ, nullptr);
+        for (int32_t i = 0; i < OPS; ++i) {
+            GDC_LightEngine::light_chunk(chunk, BLOCKS);
+        }
+        sink = sink + chunk.get_light_index(0);
+    });
+    return result;
+}
+
+// One op is an incremental light update after placing or breaking a block
+// (or an emitter) near the surface, where most edits happen.
+static Result bench_light_update(Scenario &r_scenario) {
+    constexpr int32_t OPS = 1 << 11;
+    std::mt19937 rng(5);
+    std::vector<std::array<int32_t, 4>> edits(OPS);
+    for (std::array<int32_t, 4> &edit : edits) {
+        edit = { static_cast<int32_t>(rng() % 16), 40 + static_cast<int32_t>(rng() % 40),
+            static_cast<int32_t>(rng() % 16), static_cast<int32_t>(rng() % 3) == 0 ? GLOWSTONE : static_cast<int32_t>(rng() % 2) };
+    }
+
+    // Edits land in the shared grid and are undone in reverse afterwards, so
+    // every round starts from the same terrain.
+    GDC_ChunkData &chunk = r_scenario.centre();
+    std::vector<int32_t> previous(OPS);
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        for (int32_t i = 0; i < OPS; ++i) {
+            const std::array<int32_t, 4> &edit = edits[i];
+            previous[i] = chunk.get_block(edit[0], edit[1], edit[2]);
+            if (chunk.set_block(edit[0], edit[1], edit[2], edit[3])) {
+                GDC_LightEngine::update_block(chunk, edit[0], edit[1], edit[2], BLOCKS);
+            }
+        }
+        for (int32_t i = OPS - 1; i >= 0; --i) {
+            const std::array<int32_t, 4> &edit = edits[i];
+            if (chunk.set_block(edit[0], edit[1], edit[2], previous[i])) {
+                GDC_LightEngine::update_block(chunk, edit[0], edit[1], edit[2], BLOCKS);
+            }
+        }
+    });
+    // Undoing costs about as much as applying.
+    result.ns_per_op /= 2.0;
+    return result;
+}
+
+// One op is capturing and meshing one section; every section of the centre
+// chunk is meshed per run.
+static Result bench_mesh(Scenario &r_scenario, bool p_greedy) {
+    constexpr int32_t RUNS = 16;
+    constexpr int32_t OPS = RUNS * GDC_ChunkData::SECTION_COUNT;
+    const GDC_ChunkData &chunk = r_scenario.centre();
+    GDC_ChunkData::Neighbours neighbours;
+    for (int32_t i = 0; i < 4; ++i) {
+        neighbours[i] = chunk.get_neighbour(i);
+    }
+
+    GDC_SectionCells cells;
+    std::vector<GDC_MeshQuad> quads;
+    int64_t vertices = 0;
+    GDC_ChunkData::FaceLinks links;
+    const auto run = [&]() {
+        vertices = 0;
+        for (int32_t run = 0; run < RUNS; ++run) {
+            for (int32_t section = 0; section < GDC_ChunkData::SECTION_COUNT; ++section) {
+                chunk.capture_section(section, 0, neighbours, BLOCKS, cells);
+                quads.clear();
+                if (p_greedy) {
+                    GDC_VoxelMesher::build_greedy(cells, BLOCKS, quads);
+                } else {
+                    GDC_VoxelMesher::build_naive(cells, BLOCKS, quads);
+                }
+                GDC_VoxelMesher::compute_face_links(cells, BLOCKS, links);
+                vertices += static_cast<int64_t>(quads.size()) * 4;
+            }
+        }
+    };
+
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, run);
+    result.vertices_per_second = static_cast<double>(vertices) / (result.ns_per_op * OPS) * 1e9;
+    result.allocations_per_op = count_allocations_per_op(OPS, run);
+    return result;
+}
+
+// The unit faces a set of quads covers, as (x, y, z, face, id), sorted.
+static std::vector<std::array<int32_t, 5>> expand_quads(const std::vector<GDC_MeshQuad> &p_quads) {
+    std::vector<std::array<int32_t, 5>> faces;
+    for (const GDC_MeshQuad &quad : p_quads) {
+        for (int32_t y = 0; y < quad.size[1]; ++y) {
+            for (int32_t z = 0; z < quad.size[2]; ++z) {
+                for (int32_t x = 0; x < quad.size[0]; ++x) {
+                    faces.push_back({ quad.origin[0] + x, quad.origin[1] + y, quad.origin[2] + z, quad.face, quad.id });
+                }
+            }
+        }
+    }
+    std::sort(faces.begin(), faces.end());
+    return faces;
+}
+
+// Whether greedy meshing covers exactly the faces naive meshing emits, with the
+// same block ids, in every section of the centre chunk.
+static bool check_greedy_faces(Scenario &r_scenario) {
+    const GDC_ChunkData &chunk = r_scenario.centre();
+    GDC_ChunkData::Neighbours neighbours;
+    for (int32_t i = 0; i < 4; ++i) {
+        neighbours[i] = chunk.get_neighbour(i);
+    }
+
+    GDC_SectionCells cells;
+    std::vector<GDC_MeshQuad> naive;
+    std::vector<GDC_MeshQuad> greedy;
+    for (int32_t section = 0; section < GDC_ChunkData::SECTION_COUNT; ++section) {
+        chunk.capture_section(section, 0, neighbours, BLOCKS, cells);
+        naive.clear();
+        greedy.clear();
+        GDC_VoxelMesher::build_naive(cells, BLOCKS, naive);
+        GDC_VoxelMesher::build_greedy(cells, BLOCKS, greedy);
+        if (expand_quads(naive) != expand_quads(greedy)) {
+            std::fprintf(stderr, "%s: section %d: greedy faces differ from naive faces\n", r_scenario.name.c_str(), section);
+            return false;
+        }
+    }
+    return true;
+}
+
+static Result bench_raycast(Scenario &r_scenario) {
+    constexpr int32_t OPS = 1 << 14;
+    constexpr float EXTENT = static_cast<float>(GRID * GDC_ChunkData::SIZE);
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<std::array<float, 3>> origins(OPS);
+    std::vector<std::array<float, 3>> dirs(OPS);
+    for (int32_t i = 0; i < OPS; ++i) {
+        origins[i] = { (unit(rng) * 0.5f + 0.5f) * EXTENT, (unit(rng) * 0.5f + 0.5f) * GDC_ChunkData::HEIGHT,
+            (unit(rng) * 0.5f + 0.5f) * EXTENT };
+        dirs[i] = { unit(rng), unit(rng), unit(rng) };
+    }
+
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        int64_t hits = 0;
+        GDC_RayHit hit;
+        for (int32_t i = 0; i < OPS; ++i) {
+            hits += GDC_VoxelRaycaster::cast(origins[i], dirs[i], 64.0f, &find_chunk, &r_scenario, BLOCKS, hit) ? 1 : 0;
+        }
+        sink = sink + hits;
+    });
+    return result;
+}
+
+// One op is encoding the centre chunk as a snapshot.
+static Result bench_snapshot(Scenario &r_scenario) {
+    constexpr int32_t OPS = 64;
+    const GDC_ChunkData &chunk = r_scenario.centre();
+    std::vector<uint8_t> bytes;
+
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        for (int32_t i = 0; i < OPS; ++i) {
+            GDC_ChunkCodec::encode_snapshot(chunk, bytes);
+        }
+        sink = sink + static_cast<int64_t>(bytes.size());
+    });
+    result.bytes_per_op = static_cast<double>(bytes.size());
+
+    std::vector<int32_t> original(GDC_ChunkData::BLOCK_COUNT);
+    std::vector<int32_t> decoded(GDC_ChunkData::BLOCK_COUNT);
+    chunk.store_blocks(original.data());
+    result.failed = !GDC_ChunkCodec::decode_snapshot(bytes.data(), bytes.size(), decoded.data()) || decoded != original;
+    return result;
+}
+
+// Solid stone up to y = 64 and air above, cut by a tunnel running along x
+// through the middle row of chunks at y 36-39 and a shaft from the tunnel up to
+// the surface in the centre chunk. Seen from the tunnel, the search reaches
+// the three tunnel sections, the shaft section, the solid sections bordering
+// the camera's (two beside it in z and one below), and all 36 sections of air
+// above ground: 43 sections in 9 chunks. None of the solid rock around the
+// tunnel elsewhere is reached.
+static const int32_t CAVE_VISIBLE_SECTIONS = 43;
+static const int32_t CAVE_VISIBLE_CHUNKS = GRID * GRID;
+
+static Scenario make_caves() {
+    constexpr int32_t MIDDLE = GRID / 2 * GDC_ChunkData::SIZE + GDC_ChunkData::SIZE / 2;
+    return make_scenario("caves", [](int32_t x, int32_t y, int32_t z) {
+        const bool tunnel = y >= 36 && y < 40 && (z == MIDDLE || z == MIDDLE - 1);
+        const bool shaft = y >= 36 && x == MIDDLE && z == MIDDLE;
+        return y >= 64 || tunnel || shaft ? 0 : STONE;
+    });
+}
+
+struct CaveLinks {
+    std::vector<GDC_ChunkData::FaceLinks> links; // GRID * GRID * SECTION_COUNT, as Scenario::chunks
+};
+
+static int32_t find_cave_links(int32_t p_chunk_x, int32_t p_chunk_z, int32_t section, int32_t entry_face, const void *p_userdata) {
+    if (p_chunk_x < 0 || p_chunk_z < 0 || p_chunk_x >= GRID || p_chunk_z >= GRID) { return -1; }
+    if (entry_face < 0) { return GDC_ChunkData::ALL_SECTION_FACES; }
+    const CaveLinks *p_links = static_cast<const CaveLinks *>(p_userdata);
+    return p_links->links[(p_chunk_x * GRID + p_chunk_z) * GDC_ChunkData::SECTION_COUNT + section][entry_face];
+}
+
+// One op is a visibility search from the tunnel in the centre chunk, over face
+// links computed the way meshing records them. Fails unless it reaches
+// exactly the expected sections.
+static Result bench_visibility() {
+    constexpr int32_t OPS = 256;
+    Scenario scenario = make_caves();
+
+    CaveLinks links;
+    GDC_SectionCells cells;
+    for (const std::unique_ptr<GDC_ChunkData> &chunk : scenario.chunks) {
+        GDC_ChunkData::Neighbours neighbours;
+        for (int32_t i = 0; i < 4; ++i) {
+            neighbours[i] = chunk->get_neighbour(i);
+        }
+        for (int32_t section = 0; section < GDC_ChunkData::SECTION_COUNT; ++section) {
+            chunk->capture_section(section, 0, neighbours, BLOCKS, cells);
+            links.links.emplace_back();
+            GDC_VoxelMesher::compute_face_links(cells, BLOCKS, links.links.back());
+        }
+    }
+
+    GDC_SectionVisibility visibility;
+    const int32_t start_section = 36 / GDC_ChunkData::SECTION_HEIGHT;
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        for (int32_t i = 0; i < OPS; ++i) {
+            visibility.search(GRID / 2, GRID / 2, start_section, &find_cave_links, &links);
+            sink = sink + visibility.get_visible_section_count();
+        }
+    });
+    result.allocations_per_op = count_allocations_per_op(OPS, [&]() {
+        for (int32_t i = 0; i < OPS; ++i) {
+            visibility.search(GRID / 2, GRID / 2, start_section, &find_cave_links, &links);
+        }
+    });
+    result.failed = visibility.get_visible_section_count() != CAVE_VISIBLE_SECTIONS
+            || visibility.get_visible_chunk_count() != CAVE_VISIBLE_CHUNKS;
+    return result;
+}
+
+// One op is generating the terrain of one chunk with GDC_TerrainGenerator's
+// default settings, walking along a row of chunks so no two ops share a column.
+// Independent of the scenarios, so it runs once.
+static Result bench_generate_column() {
+    constexpr int32_t OPS = 64;
+    GDC_TerrainColumn column;
+    column.stone = STONE;
+    column.dirt = DIRT;
+    column.grass = GRASS;
+    std::vector<int32_t> ids(GDC_ChunkData::BLOCK_COUNT);
+
+    Result result;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        for (int32_t i = 0; i < OPS; ++i) {
+            column.generate(i, -i, ids.data());
+            sink = sink + ids[GDC_ChunkData::BLOCK_COUNT / 4];
+        }
+    });
+    result.chunks_per_second = 1e9 / result.ns_per_op;
+    result.allocations_per_op = count_allocations_per_op(OPS, [&]() {
+        for (int32_t i = 0; i < OPS; ++i) {
+            column.generate(i, -i, ids.data());
+        }
+    });
+    return result;
+}
+
+// Random edits of the centre chunk arrive in ticks of EDITS_PER_TICK, and each
+// tick's edits are coalesced into one delta, as a world recording its edits
+// does. One op is one edit: sorting and encoding it, or decoding it and
+// applying it with its light update to an unlinked copy of the chunk. Bytes
+// are per edit made, before coalescing.
+static Result bench_delta(Scenario &r_scenario, bool p_apply) {
+    constexpr int32_t EDITS_PER_TICK = 64;
+    constexpr int32_t TICKS = 256;
+    constexpr int32_t OPS = EDITS_PER_TICK * TICKS;
+    std::mt19937 rng(6);
+
+    GDC_ChunkData source = r_scenario.centre();
+    for (int32_t i = 0; i < 4; ++i) {
+        source.set_neighbour(i, nullptr);
+    }
+    const GDC_ChunkData start = source;
+
+    std::vector<std::vector<int32_t>> tick_indices(TICKS);
+    std::vector<std::vector<uint8_t>> deltas(TICKS);
+    std::vector<uint8_t> edited(GDC_ChunkData::BLOCK_COUNT, 0);
+    int64_t delta_bytes = 0;
+    for (int32_t tick = 0; tick < TICKS; ++tick) {
+        std::vector<int32_t> &indices = tick_indices[tick];
+        for (int32_t i = 0; i < EDITS_PER_TICK; ++i) {
+            const int32_t index = static_cast<int32_t>(rng() % GDC_ChunkData::BLOCK_COUNT);
+            const int32_t id = static_cast<int32_t>(rng() % 4);
+            if (source.set_block(index % 16, index / 256, (index / 16) % 16, id) && !edited[index]) {
+                edited[index] = 1;
+                indices.push_back(index);
+            }
+        }
+        for (int32_t index : indices) {
+            edited[index] = 0;
+        }
+        std::vector<int32_t> sorted = indices;
+        std::sort(sorted.begin(), sorted.end());
+        GDC_ChunkCodec::encode_delta(source, sorted.data(), static_cast<int32_t>(sorted.size()), deltas[tick]);
+        delta_bytes += static_cast<int64_t>(deltas[tick].size());
+    }
+
+    Result result;
+    result.bytes_per_op = static_cast<double>(delta_bytes) / OPS;
+    if (!p_apply) {
+        std::vector<int32_t> sorted;
+        std::vector<uint8_t> bytes;
+        result.ns_per_op = time_ns_per_op(OPS, [&]() {
+            for (const std::vector<int32_t> &indices : tick_indices) {
+                sorted.assign(indices.begin(), indices.end());
+                std::sort(sorted.begin(), sorted.end());
+                GDC_ChunkCodec::encode_delta(source, sorted.data(), static_cast<int32_t>(sorted.size()), bytes);
+                sink = sink + static_cast<int64_t>(bytes.size());
+            }
+        });
+        return result;
+    }
+
+    std::vector<int32_t> indices;
+    std::vector<int32_t> ids;
+    GDC_ChunkData target = start;
+    result.ns_per_op = time_ns_per_op(OPS, [&]() {
+        target = start;
+        for (const std::vector<uint8_t> &delta : deltas) {
+            if (!GDC_ChunkCodec::decode_delta(delta.data(), delta.size(), indices, ids)) {
+                result.failed = true;
+                return;
+            }
+            for (size_t i = 0; i < indices.size(); ++i) {
+                const int32_t index = indices[i];
+                const int32_t x = index % 16;
+                const int32_t y = index / 256;
+                const int32_t z = (index / 16) % 16;
+                if (target.set_block(x, y, z, ids[i])) {
+                    GDC_LightEngine::update_block(target, x, y, z, BLOCKS);
+                }
+            }
+        }
+    });
+
+    std::vector<int32_t> expected(GDC_ChunkData::BLOCK_COUNT);
+    std::vector<int32_t> actual(GDC_ChunkData::BLOCK_COUNT);
+    source.store_blocks(expected.data());
+    target.store_blocks(actual.data());
+    result.failed = result.failed || actual != expected;
+    return result;
+}
+
+int main(int argc, char **argv) {
+    const bool csv = argc > 1 && std::strcmp(argv[1], "--csv") == 0;
+
+    std::vector<Scenario> scenarios;
+    scenarios.push_back(make_flat());
+    scenarios.push_back(make_noise());
+    scenarios.push_back(make_checkerboard());
+
+    if (csv) {
+        std::printf("scenario,benchmark,ns_per_op,vertices_per_second,chunks_per_second,allocations_per_op,bytes_per_op\n");
+    } else {
+        std::printf("%-14s %-16s %12s %16s %10s %10s %10s\n", "scenario", "benchmark", "ns/op", "vertices/s", "chunks/s", "allocs/op",
+                "bytes/op");
+    }
+
+    bool meshing_allocated = false;
+    bool codec_failed = false;
+    bool greedy_mismatch = false;
+    auto report = [csv](const std::string &p_scenario, const char *p_benchmark, const Result &p_result) {
+        if (csv) {
+            std::printf("%s,%s,%.2f,%.0f,%.0f,%.3f,%.2f\n", p_scenario.c_str(), p_benchmark, p_result.ns_per_op,
+                    p_result.vertices_per_second, p_result.chunks_per_second, p_result.allocations_per_op, p_result.bytes_per_op);
+        } else {
+            char vertices[32] = "-";
+            char chunks[32] = "-";
+            char allocations[32] = "-";
+            char bytes[32] = "-";
+            if (p_result.vertices_per_second > 0.0) {
+                std::snprintf(vertices, sizeof(vertices), "%.0f", p_result.vertices_per_second);
+            }
+            if (p_result.chunks_per_second > 0.0) {
+                std::snprintf(chunks, sizeof(chunks), "%.0f", p_result.chunks_per_second);
+            }
+            if (p_result.allocations_per_op >= 0.0) {
+                std::snprintf(allocations, sizeof(allocations), "%.3f", p_result.allocations_per_op);
+            }
+            if (p_result.bytes_per_op >= 0.0) {
+                std::snprintf(bytes, sizeof(bytes), "%.2f", p_result.bytes_per_op);
+            }
+            std::printf("%-14s %-16s %12.2f %16s %10s %10s %10s\n", p_scenario.c_str(), p_benchmark, p_result.ns_per_op,
+                    vertices, chunks, allocations, bytes);
+        }
+        std::fflush(stdout);
+    };
+
+    report("terrain", "generate_column", bench_generate_column());
+    const Result visibility = bench_visibility();
+    report("caves", "visibility", visibility);
+    const bool visibility_failed = visibility.failed;
+    for (Scenario &scenario : scenarios) {
+        report(scenario.name, "get_block", bench_get_block(scenario));
+        report(scenario.name, "set_block", bench_set_block(scenario));
+        report(scenario.name, "fill_range", bench_fill_range(scenario));
+        report(scenario.name, "light_chunk", bench_light_chunk(scenario));
+        report(scenario.name, "light_update", bench_light_update(scenario));
+        for (const bool greedy : { false, true }) {
+            const Result result = bench_mesh(scenario, greedy);
+            report(scenario.name, greedy ? "mesh_greedy" : "mesh_naive", result);
+            meshing_allocated = meshing_allocated || result.allocations_per_op > 0.0;
+        }
+        greedy_mismatch = !check_greedy_faces(scenario) || greedy_mismatch;
+        report(scenario.name, "raycast", bench_raycast(scenario));
+
+        const Result snapshot = bench_snapshot(scenario);
+        const Result delta_encode = bench_delta(scenario, false);
+        const Result delta_apply = bench_delta(scenario, true);
+        report(scenario.name, "snapshot", snapshot);
+        report(scenario.name, "delta_encode", delta_encode);
+        report(scenario.name, "delta_apply", delta_apply);
+        codec_failed = codec_failed || snapshot.failed || delta_apply.failed;
+    }
+
+    if (meshing_allocated) {
+        std::fprintf(stderr, "error: steady-state meshing allocated memory\n");
+        return 1;
+    }
+    if (greedy_mismatch) {
+        std::fprintf(stderr, "error: greedy meshing does not cover the same faces as naive meshing\n");
+        return 1;
+    }
+    if (visibility_failed) {
+        std::fprintf(stderr, "error: cave culling did not reach the expected sections\n");
+        return 1;
+    }
+    if (codec_failed) {
+        std::fprintf(stderr, "error: chunk snapshots or deltas did not reproduce the blocks\n");
+        return 1;
+    }
+    return 0;
+}
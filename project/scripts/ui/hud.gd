@@ -2,12 +2,49 @@
 extends CanvasLayer
 
 @export var show_debug_info: bool = true
+## Also lists the world's "gdcraft/" performance monitors under the FPS counter.
+@export var show_world_stats: bool = true
+
+## Monitors shown in the overlay, with their labels and units.
+const WORLD_STATS := [
+	["gdcraft/process_ms", "World process", "%.2f ms"],
+	["gdcraft/meshes_built", "Meshes built", "%d"],
+	["gdcraft/mesh_time_mean_ms", "Mesh time mean", "%.3f ms"],
+	["gdcraft/mesh_time_p99_ms", "Mesh time p99", "%.3f ms"],
+	["gdcraft/mesh_apply_ms", "Mesh apply", "%.2f ms"],
+	["gdcraft/vertices_emitted", "Vertices emitted", "%d"],
+	["gdcraft/collision_build_ms", "Collision build", "%.2f ms"],
+	["gdcraft/collision_free_ms", "Collision free", "%.2f ms"],
+	["gdcraft/raycasts", "Raycasts", "%d"],
+	["gdcraft/raycast_ms", "Raycast time", "%.3f ms"],
+	["gdcraft/loaded_chunks", "Loaded chunks", "%d"],
+	["gdcraft/block_storage_bytes", "Block storage", "%.1f MiB", 1.0 / 1048576.0],
+	["gdcraft/mesh_bytes", "Mesh memory", "%.1f MiB", 1.0 / 1048576.0],
+	["gdcraft/pending_mesh_jobs", "Pending meshes", "%d"],
+	["gdcraft/pending_generate_jobs", "Pending generation", "%d"],
+	["gdcraft/pending_save_jobs", "Pending saves", "%d"],
+]
 
 @onready var fps_label: Label = $DebugInfo/FPSLabel
+@onready var stats_label: Label = $DebugInfo/StatsLabel
 
 func _ready() -> void:
 	fps_label.visible = show_debug_info
+	stats_label.visible = show_debug_info and show_world_stats
 
 func _process(_delta: float) -> void:
 	if show_debug_info:
 		fps_label.text = "FPS: %d" % Engine.get_frames_per_second()
+	if stats_label.visible:
+		stats_label.text = _format_world_stats()
+
+func _format_world_stats() -> String:
+	var lines := PackedStringArray()
+	for stat in WORLD_STATS:
+		if not Performance.has_custom_monitor(stat[0]):
+			continue
+		var value: float = Performance.get_custom_monitor(stat[0])
+		if stat.size() > 3:
+			value *= stat[3]
+		lines.append("%s: %s" % [stat[1], stat[2] % value])
+	return "\n".join(lines)
@@ -1,40 +1,34 @@
-## Procedurally populates a [World] with [Chunk]s on [method _ready].
-## Replace or extend [method generate] to implement custom terrain algorithms.
+## Populates a [GDC_World] with terrain from a native [GDC_TerrainGenerator] on [method _ready].
+## Configure the terrain through the [member terrain] resource. When the world
+## streams chunks around its viewer, the generator is handed to the world instead.
 class_name WorldGenerator
 extends Node
 
 
 @export var world: GDC_World
+## Terrain settings. A generator with default settings is used when left empty.
+@export var terrain: GDC_TerrainGenerator
+## Number of chunks generated in each direction around the origin. Unused when
+## the world has [member GDC_World.streaming_enabled] set.
+@export var radius: int = 4
 
 
 func _ready() -> void:
 	generate()
 
 
-## Fills a 4×4 grid of chunks with a simple flat terrain.
+## Generates a (2 * radius)² area of chunks centred on the origin. Columns are
+## filled in parallel on worker threads and meshed asynchronously by the world.
 func generate() -> void:
 	if world == null:
 		push_warning("WorldGenerator: world node is not set.")
 		return
-	
-	var stone = BlockRegistry.get_block_by_name("stone")
-	var dirt = BlockRegistry.get_block_by_name("dirt")
-	var grass = BlockRegistry.get_block_by_name("grass")
 
-	if stone == null or dirt == null or grass == null:
-		push_error("WorldGenerator: required blocks (stone/dirt/grass) are missing in BlockRegistry.")
+	if terrain == null:
+		terrain = GDC_TerrainGenerator.new()
+
+	if world.streaming_enabled:
+		world.terrain_generator = terrain
 		return
 
-	var chunks: Array[GDC_Chunk] = []
-	for z in range(4):
-		for x in range(4):
-			var chunk := GDC_Chunk.new()
-			chunk.fill_range(Vector3i.ZERO,     Vector3i(16, 2, 16), stone.id)
-			chunk.fill_range(Vector3i(0, 2, 0), Vector3i(16, 4, 16), dirt.id)
-			chunk.fill_range(Vector3i(0, 4, 0), Vector3i(16, 5, 16), grass.id)
-			chunk.set_block(8, 6, 8, stone.id)
-			world.register_chunk(chunk, Vector2i(x, z))
-			chunks.append(chunk)
-
-	for chunk in chunks:
-		chunk.generate_mesh()
+	terrain.generate_area(world, Vector2i(-radius, -radius), Vector2i(radius, radius))
@@ -13,9 +13,33 @@ void GDC_BlockData::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_color", "color"), &GDC_BlockData::set_color);
     ADD_PROPERTY(PropertyInfo(Variant::COLOR, "color"), "set_color", "get_color");
 
+    ClassDB::bind_method(D_METHOD("get_texture"), &GDC_BlockData::get_texture);
+    ClassDB::bind_method(D_METHOD("set_texture", "texture"), &GDC_BlockData::set_texture);
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_texture", "get_texture");
+
+    ClassDB::bind_method(D_METHOD("get_light_emission"), &GDC_BlockData::get_light_emission);
+    ClassDB::bind_method(D_METHOD("set_light_emission", "level"), &GDC_BlockData::set_light_emission);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "light_emission", PROPERTY_HINT_RANGE, "0,15"), "set_light_emission", "get_light_emission");
+
+    ClassDB::bind_method(D_METHOD("get_render_layer"), &GDC_BlockData::get_render_layer);
+    ClassDB::bind_method(D_METHOD("set_render_layer", "layer"), &GDC_BlockData::set_render_layer);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "render_layer", PROPERTY_HINT_ENUM, "Opaque,Transparent,Cutout"), "set_render_layer", "get_render_layer");
+
+    ClassDB::bind_method(D_METHOD("is_solid"), &GDC_BlockData::is_solid);
+    ClassDB::bind_method(D_METHOD("set_solid", "solid"), &GDC_BlockData::set_solid);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "solid"), "set_solid", "is_solid");
+
+    ClassDB::bind_method(D_METHOD("has_random_ticks"), &GDC_BlockData::has_random_ticks);
+    ClassDB::bind_method(D_METHOD("set_random_ticks", "random_ticks"), &GDC_BlockData::set_random_ticks);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "random_ticks"), "set_random_ticks", "has_random_ticks");
+
     ClassDB::bind_method(D_METHOD("get_id"), &GDC_BlockData::get_id);
     ClassDB::bind_method(D_METHOD("set_id"), &GDC_BlockData::set_id);
     ADD_PROPERTY(PropertyInfo(Variant::INT, "id"), "set_id", "get_id");
+
+    BIND_ENUM_CONSTANT(RENDER_LAYER_OPAQUE);
+    BIND_ENUM_CONSTANT(RENDER_LAYER_TRANSPARENT);
+    BIND_ENUM_CONSTANT(RENDER_LAYER_CUTOUT);
 }
 
 String GDC_BlockData::get_block_name() const {
@@ -34,6 +58,46 @@ void GDC_BlockData::set_color(const Color &p_color) {
     color = p_color;
 }
 
+Ref<Texture2D> GDC_BlockData::get_texture() const {
+    return texture;
+}
+
+void GDC_BlockData::set_texture(const Ref<Texture2D> &p_texture) {
+    texture = p_texture;
+}
+
+int32_t GDC_BlockData::get_light_emission() const {
+    return light_emission;
+}
+
+void GDC_BlockData::set_light_emission(int32_t p_level) {
+    light_emission = CLAMP(p_level, 0, 15);
+}
+
+GDC_BlockData::RenderLayer GDC_BlockData::get_render_layer() const {
+    return render_layer;
+}
+
+void GDC_BlockData::set_render_layer(RenderLayer p_layer) {
+    render_layer = p_layer;
+}
+
+bool GDC_BlockData::is_solid() const {
+    return solid;
+}
+
+void GDC_BlockData::set_solid(bool p_solid) {
+    solid = p_solid;
+}
+
+bool GDC_BlockData::has_random_ticks() const {
+    return random_ticks;
+}
+
+void GDC_BlockData::set_random_ticks(bool p_random_ticks) {
+    random_ticks = p_random_ticks;
+}
+
 int32_t GDC_BlockData::get_id() const {
     return id;
 }
@@ -1,16 +1,34 @@
 #pragma once
 
 #include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/classes/texture2d.hpp>
 #include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/string.hpp>
 
+#include "core/block_table.h"
+
 namespace godot {
 
 class GDC_BlockData : public Resource {
     GDCLASS(GDC_BlockData, Resource)
 
+public:
+    // See-through blocks let light pass and show what is behind them; texels
+    // with alpha below 0.5 are cut out of their faces.
+    enum RenderLayer {
+        RENDER_LAYER_OPAQUE = GDC_BlockTable::RENDER_LAYER_OPAQUE,
+        RENDER_LAYER_TRANSPARENT = GDC_BlockTable::RENDER_LAYER_TRANSPARENT, // glass: faces between two of them are culled
+        RENDER_LAYER_CUTOUT = GDC_BlockTable::RENDER_LAYER_CUTOUT,           // leaves: every face is drawn
+    };
+
+private:
     String block_name;
     Color color;
+    Ref<Texture2D> texture; // optional, tinted by `color`
+    int32_t light_emission = 0; // block light level it gives off, 0-15
+    RenderLayer render_layer = RENDER_LAYER_OPAQUE;
+    bool solid = true; // collided with and hit by raycasts
+    bool random_ticks = false; // picked by the world's random ticks, see GDC_World
     int32_t id = 0;
 
 protected:
@@ -26,8 +44,25 @@ public:
     Color get_color() const;
     void set_color(const Color &p_color);
 
+    Ref<Texture2D> get_texture() const;
+    void set_texture(const Ref<Texture2D> &p_texture);
+
+    int32_t get_light_emission() const;
+    void set_light_emission(int32_t p_level);
+
+    RenderLayer get_render_layer() const;
+    void set_render_layer(RenderLayer p_layer);
+
+    bool is_solid() const;
+    void set_solid(bool p_solid);
+
+    bool has_random_ticks() const;
+    void set_random_ticks(bool p_random_ticks);
+
     int32_t get_id() const;
     void set_id(int32_t p_id);
 };
 
 } // namespace godot
+
+VARIANT_ENUM_CAST(GDC_BlockData::RenderLayer);
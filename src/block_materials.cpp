@@ -0,0 +1,160 @@
+#include "block_materials.h"
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/shader.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+using namespace godot;
+
+// Shared by both vertex formats. Standard meshes carry the shaded colour in
+// COLOR, with alpha 0 for see-through blocks, and the texture layer in UV2.x;
+// compact meshes carry the packed integers described in chunk_mesher.h and look
+// colour, layer and see-through up by block id. See-through blocks cut out
+// texels with alpha below 0.5; opaque ones ignore texture alpha, since the
+// mesher has already culled the faces behind them. The face
+// tables and shading match GDC_ChunkMesher. Light is baked into the vertices by
+// GDC_LightEngine, so the terrain is unshaded.
+static const char *CHUNK_SHADER_HEADER = R"(
+shader_type spatial;
+render_mode unshaded;
+)";
+
+static const char *CHUNK_SHADER_BODY = R"(
+uniform sampler2D block_table : filter_nearest;
+uniform sampler2DArray block_textures : filter_nearest_mipmap, repeat_enable;
+
+const vec3 FACE_NORMALS[6] = vec3[](
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0), vec3(-1.0, 0.0, 0.0),
+    vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0));
+const float FACE_BRIGHTNESS[6] = float[](1.0, 0.6, 0.85, 0.75, 0.9, 0.8);
+const float LIGHT_BRIGHTNESS[16] = float[](
+    0.035, 0.044, 0.055, 0.069, 0.086, 0.107, 0.134, 0.168,
+    0.210, 0.262, 0.328, 0.410, 0.512, 0.640, 0.800, 1.0);
+const float AO_BRIGHTNESS[4] = float[](0.5, 0.7, 0.85, 1.0);
+const vec2 FACE_UVS[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+varying vec3 block_color;
+varying flat float layer;
+varying flat float see_through;
+
+void vertex() {
+#ifdef COMPACT_VERTICES
+    uvec2 packed = uvec2(round(VERTEX.xy));
+    uint face = min((packed.x >> 15u) & 7u, 5u);
+    uint corner = (packed.x >> 18u) & 3u;
+    uint ao = (packed.x >> 20u) & 3u;
+    int block_id = int(packed.y & 4095u);
+    uint light = (packed.y >> 12u) & 15u;
+    vec2 extent = vec2(float(((packed.y >> 16u) & 15u) + 1u), float(((packed.y >> 20u) & 15u) + 1u));
+
+    VERTEX = vec3(uvec3(packed.x & 31u, (packed.x >> 5u) & 31u, (packed.x >> 10u) & 31u));
+    NORMAL = FACE_NORMALS[face];
+    UV = FACE_UVS[corner] * extent;
+
+    int last_id = textureSize(block_table, 0).x - 1;
+    vec4 entry = texelFetch(block_table, ivec2(min(block_id, last_id), 0), 0);
+    block_color = entry.rgb * FACE_BRIGHTNESS[face] * LIGHT_BRIGHTNESS[light] * AO_BRIGHTNESS[ao];
+    layer = abs(entry.a) - 1.0;
+    see_through = entry.a < 0.0 ? 1.0 : 0.0;
+#else
+    block_color = COLOR.rgb;
+    layer = UV2.x;
+    see_through = 1.0 - COLOR.a;
+#endif
+}
+
+void fragment() {
+    vec3 albedo = block_color;
+    float alpha = 1.0;
+    if (layer >= 0.0) {
+        // UVs run across the whole merged quad; the explicit gradients keep
+        // fract() from picking the smallest mip along tile seams.
+        vec4 texel = textureGrad(block_textures, vec3(fract(UV), layer), dFdx(UV), dFdy(UV));
+        albedo *= texel.rgb;
+        alpha = see_through > 0.5 ? texel.a : 1.0;
+    }
+    ALBEDO = albedo;
+    ALPHA = alpha;
+    ALPHA_SCISSOR_THRESHOLD = 0.5;
+}
+)";
+
+void GDC_BlockMaterials::rebuild(const std::vector<Ref<GDC_BlockData>> &p_blocks, int32_t p_texture_size) {
+    if (standard_material.is_null()) {
+        create_materials();
+    }
+
+    const int32_t count = static_cast<int32_t>(p_blocks.size());
+    layers_by_id.assign(count + 1, -1);
+    layer_count = 0;
+
+    TypedArray<Image> layers;
+    for (int32_t id = 1; id <= count; ++id) {
+        const Ref<Texture2D> texture = p_blocks[id - 1]->get_texture();
+        if (texture.is_null()) { continue; }
+
+        Ref<Image> image = texture->get_image();
+        if (image.is_null()) { continue; }
+
+        image = image->duplicate();
+        if (image->is_compressed()) {
+            image->decompress();
+        }
+        image->clear_mipmaps();
+        image->convert(Image::FORMAT_RGBA8);
+        if (image->get_width() != p_texture_size || image->get_height() != p_texture_size) {
+            image->resize(p_texture_size, p_texture_size, Image::INTERPOLATE_NEAREST);
+        }
+        image->generate_mipmaps();
+
+        layers_by_id[id] = layer_count++;
+        layers.push_back(image);
+    }
+
+    // The sampler needs an array even when no block is textured.
+    if (layers.size() == 0) {
+        Ref<Image> blank = Image::create_empty(1, 1, false, Image::FORMAT_RGBA8);
+        blank->fill(Color(1.0f, 1.0f, 1.0f, 1.0f));
+        layers.push_back(blank);
+    }
+    textures.instantiate();
+    textures->create_from_images(layers);
+
+    // Unknown ids render red and untextured, like the mesher's colour table.
+    Ref<Image> table = Image::create_empty(count + 1, 1, false, Image::FORMAT_RGBAF);
+    table->fill(Color(1.0f, 0.0f, 0.0f, 0.0f));
+    for (int32_t id = 1; id <= count; ++id) {
+        const Ref<GDC_BlockData> &block = p_blocks[id - 1];
+        const Color color = block->get_color();
+        const bool see_through = block->get_render_layer() != GDC_BlockData::RENDER_LAYER_OPAQUE;
+        const float layer = static_cast<float>(layers_by_id[id] + 1);
+        table->set_pixel(id, 0, Color(color.r, color.g, color.b, see_through ? -layer : layer));
+    }
+    block_table = ImageTexture::create_from_image(table);
+
+    for (const Ref<ShaderMaterial> &material : { standard_material, compact_material }) {
+        material->set_shader_parameter("block_table", block_table);
+        material->set_shader_parameter("block_textures", textures);
+    }
+}
+
+int32_t GDC_BlockMaterials::get_texture_layer(int32_t id) const {
+    if (id >= 0 && id < static_cast<int32_t>(layers_by_id.size())) {
+        return layers_by_id[id];
+    }
+    return -1;
+}
+
+void GDC_BlockMaterials::create_materials() {
+    Ref<Shader> standard_shader;
+    standard_shader.instantiate();
+    standard_shader->set_code(String(CHUNK_SHADER_HEADER) + CHUNK_SHADER_BODY);
+    standard_material.instantiate();
+    standard_material->set_shader(standard_shader);
+
+    Ref<Shader> compact_shader;
+    compact_shader.instantiate();
+    compact_shader->set_code(String(CHUNK_SHADER_HEADER) + "#define COMPACT_VERTICES\n" + CHUNK_SHADER_BODY);
+    compact_material.instantiate();
+    compact_material->set_shader(compact_shader);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/classes/texture2d_array.hpp>
+
+#include "block_data.h"
+
+namespace godot {
+
+// The chunk materials shared by every chunk, owned by GDC_BlockRegistry.
+//
+// Block textures are packed into one Texture2DArray, one layer per textured
+// block, and block colours and layers are kept in a small lookup texture indexed
+// by block id. There is one material per vertex format, both built from the same
+// shader, so the number of materials does not grow with the number of chunks.
+class GDC_BlockMaterials {
+public:
+    // `p_blocks[i]` is the block with id i + 1. Every texture is resized to
+    // `p_texture_size` squared so they fit in one array.
+    void rebuild(const std::vector<Ref<GDC_BlockData>> &p_blocks, int32_t p_texture_size);
+
+    Ref<ShaderMaterial> get_standard_material() const { return standard_material; }
+    Ref<ShaderMaterial> get_compact_material() const { return compact_material; }
+
+    // Texture array layer of the block, or -1 if it has no texture.
+    int32_t get_texture_layer(int32_t id) const;
+    int32_t get_layer_count() const { return layer_count; }
+
+private:
+    void create_materials();
+
+    Ref<ShaderMaterial> standard_material;
+    Ref<ShaderMaterial> compact_material;
+    Ref<Texture2DArray> textures;
+    Ref<ImageTexture> block_table; // x = id: rgb colour, a = layer + 1 (0 = untextured), negated if see-through
+    std::vector<int32_t> layers_by_id;
+    int32_t layer_count = 0;
+};
+
+} // namespace godot
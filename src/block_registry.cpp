@@ -17,6 +17,18 @@ void GDC_BlockRegistry::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_block_by_id", "id"), &GDC_BlockRegistry::get_block_by_id);
     ClassDB::bind_method(D_METHOD("get_block_by_name", "name"), &GDC_BlockRegistry::get_block_by_name);
     ClassDB::bind_method(D_METHOD("get_block_count"), &GDC_BlockRegistry::get_block_count);
+
+    ClassDB::bind_method(D_METHOD("set_tick_handler", "id", "handler"), &GDC_BlockRegistry::set_tick_handler);
+    ClassDB::bind_method(D_METHOD("get_tick_handler", "id"), &GDC_BlockRegistry::get_tick_handler);
+    ClassDB::bind_method(D_METHOD("has_tick_handler", "id"), &GDC_BlockRegistry::has_tick_handler);
+
+    ClassDB::bind_method(D_METHOD("get_texture_size"), &GDC_BlockRegistry::get_texture_size);
+    ClassDB::bind_method(D_METHOD("set_texture_size", "size"), &GDC_BlockRegistry::set_texture_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "texture_size", PROPERTY_HINT_RANGE, "1,512"), "set_texture_size", "get_texture_size");
+
+    ClassDB::bind_method(D_METHOD("get_standard_material"), &GDC_BlockRegistry::get_standard_material);
+    ClassDB::bind_method(D_METHOD("get_compact_material"), &GDC_BlockRegistry::get_compact_material);
+    ClassDB::bind_method(D_METHOD("get_texture_layer", "id"), &GDC_BlockRegistry::get_texture_layer);
 }
 
 GDC_BlockRegistry *GDC_BlockRegistry::get_singleton() {
@@ -66,23 +78,92 @@ int32_t GDC_BlockRegistry::get_block_count() const {
     return static_cast<int32_t>(blocks_by_id.size());
 }
 
+const GDC_BlockTable &GDC_BlockRegistry::get_block_table() const {
+    return block_table;
+}
+
+void GDC_BlockRegistry::set_tick_handler(int32_t id, const Callable &p_handler) {
+    ERR_FAIL_COND_MSG(id <= 0, "set_tick_handler: air cannot be ticked.");
+    if (static_cast<size_t>(id) >= tick_handlers.size()) {
+        tick_handlers.resize(id + 1);
+    }
+    tick_handlers[id] = p_handler;
+}
+
+Callable GDC_BlockRegistry::get_tick_handler(int32_t id) const {
+    if (id > 0 && static_cast<size_t>(id) < tick_handlers.size()) {
+        return tick_handlers[id];
+    }
+    return Callable();
+}
+
+bool GDC_BlockRegistry::has_tick_handler(int32_t id) const {
+    return id > 0 && static_cast<size_t>(id) < tick_handlers.size() && tick_handlers[id].is_valid();
+}
+
+int32_t GDC_BlockRegistry::get_texture_size() const {
+    return texture_size;
+}
+
+void GDC_BlockRegistry::set_texture_size(int32_t p_size) {
+    texture_size = MAX(p_size, 1);
+    if (is_inside_tree()) {
+        reload();
+    }
+}
+
+Ref<ShaderMaterial> GDC_BlockRegistry::get_standard_material() const {
+    return materials.get_standard_material();
+}
+
+Ref<ShaderMaterial> GDC_BlockRegistry::get_compact_material() const {
+    return materials.get_compact_material();
+}
+
+int32_t GDC_BlockRegistry::get_texture_layer(int32_t id) const {
+    return materials.get_texture_layer(id);
+}
+
+const std::vector<Color> &GDC_BlockRegistry::get_color_table() const {
+    return color_table;
+}
+
+const std::vector<int32_t> &GDC_BlockRegistry::get_layer_table() const {
+    return layer_table;
+}
+
 void GDC_BlockRegistry::reload() {
     blocks_by_id.clear();
     blocks_by_name.clear();
 
-    if (block_set.is_null()) {
-        return;
+    if (block_set.is_valid()) {
+        const TypedArray<GDC_BlockData> blocks = block_set->get_blocks();
+        for (int i = 0; i < blocks.size(); ++i) {
+            Ref<GDC_BlockData> block = blocks[i];
+            if (block.is_null()) {
+                continue;
+            }
+            const int32_t id = static_cast<int>(blocks_by_id.size()) + 1;
+            block->set_id(id);
+            blocks_by_id.push_back(block);
+            blocks_by_name.insert(block->get_block_name().to_lower(), block);
+        }
+    }
+
+    block_table.reset(static_cast<int32_t>(blocks_by_id.size()) + 1);
+    for (const Ref<GDC_BlockData> &block : blocks_by_id) {
+        block_table.set_block(block->get_id(), static_cast<GDC_BlockTable::RenderLayer>(block->get_render_layer()),
+                block->is_solid(), static_cast<uint8_t>(block->get_light_emission()));
+        block_table.set_random_ticks(block->get_id(), block->has_random_ticks());
     }
+    block_table.build_face_culling();
 
-    const TypedArray<GDC_BlockData> blocks = block_set->get_blocks();
-    for (int i = 0; i < blocks.size(); ++i) {
-        Ref<GDC_BlockData> block = blocks[i];
-        if (block.is_null()) {
-            continue;
-        }
-        const int32_t id = static_cast<int>(blocks_by_id.size()) + 1;
-        block->set_id(id);
-        blocks_by_id.push_back(block);
-        blocks_by_name.insert(block->get_block_name().to_lower(), block);
+    materials.rebuild(blocks_by_id, texture_size);
+
+    color_table.assign(blocks_by_id.size() + 1, Color(1.0f, 0.0f, 0.0f, 1.0f));
+    layer_table.assign(blocks_by_id.size() + 1, -1);
+    for (const Ref<GDC_BlockData> &block : blocks_by_id) {
+        color_table[block->get_id()] = block->get_color();
+        layer_table[block->get_id()] = materials.get_texture_layer(block->get_id());
     }
 }
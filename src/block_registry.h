@@ -3,11 +3,16 @@
 #include <vector>
 
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/string.hpp>
 
 #include "block_data.h"
+#include "block_materials.h"
 #include "block_set.h"
+#include "core/block_table.h"
 
 namespace godot {
 
@@ -19,6 +24,13 @@ class GDC_BlockRegistry : public Node {
     Ref<GDC_BlockSet> block_set;
     std::vector<Ref<GDC_BlockData>> blocks_by_id;   // index 0 = block with id 1
     HashMap<String, Ref<GDC_BlockData>> blocks_by_name; // lowercase keys
+    GDC_BlockTable block_table;
+    std::vector<Color> color_table;                     // indexed by id
+    std::vector<int32_t> layer_table;                   // indexed by id, -1 = untextured
+    std::vector<Callable> tick_handlers;                // indexed by id, kept across reloads
+
+    GDC_BlockMaterials materials;
+    int32_t texture_size = 16;
 
 protected:
     static void _bind_methods();
@@ -39,6 +51,33 @@ public:
     Ref<GDC_BlockData> get_block_by_name(const String &p_name) const;
     int32_t get_block_count() const;
 
+    // Render layer, solidity, light emission and face culling of every block
+    // by id, compiled on reload for the mesher, light engine, raycaster and
+    // collision.
+    const GDC_BlockTable &get_block_table() const;
+
+    // Called as handler(world, position: Vector3i, id: int, random: bool) when a
+    // block with this id gets a tick scheduled with GDC_World.schedule_tick() or,
+    // if it has random_ticks set, a random tick. Edits the handler makes go
+    // through the world's usual edit path and are remeshed with the tick's batch.
+    void set_tick_handler(int32_t id, const Callable &p_handler);
+    Callable get_tick_handler(int32_t id) const;
+    bool has_tick_handler(int32_t id) const;
+
+    int32_t get_texture_size() const;
+    void set_texture_size(int32_t p_size);
+
+    // Chunk materials shared by every chunk, one per vertex format. They sample
+    // block textures from a Texture2DArray rebuilt on every reload.
+    Ref<ShaderMaterial> get_standard_material() const;
+    Ref<ShaderMaterial> get_compact_material() const;
+    int32_t get_texture_layer(int32_t id) const;
+
+    // Colour and texture layer of every block by id, compiled on reload so
+    // meshing copies them instead of querying each GDC_BlockData.
+    const std::vector<Color> &get_color_table() const;
+    const std::vector<int32_t> &get_layer_table() const;
+
 private:
     void reload();
 };
@@ -1,65 +1,23 @@
 #include "chunk.h"
 
 #include <algorithm>
-#include <vector>
+#include <utility>
 
 #include <godot_cpp/core/class_db.hpp>
 
-#include <godot_cpp/classes/collision_shape3d.hpp>
-#include <godot_cpp/classes/concave_polygon_shape3d.hpp>
-#include <godot_cpp/classes/standard_material3d.hpp>
-#include <godot_cpp/classes/static_body3d.hpp>
+#include <godot_cpp/classes/physics_server3d.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/variant/aabb.hpp>
 
-#include <godot_cpp/variant/packed_vector3_array.hpp>
-#include <godot_cpp/variant/packed_int32_array.hpp>
-#include <godot_cpp/variant/packed_vector2_array.hpp>
-#include <godot_cpp/variant/packed_color_array.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include "block_registry.h"
+#include "chunk_mesher.h"
+#include "collision_builder.h"
+#include "core/chunk_codec.h"
 
 using namespace godot;
 
-enum FaceDir {
-    FACE_UP = 0,
-    FACE_BACK,
-    FACE_LEFT,
-    FACE_RIGHT,
-    FACE_TOP,
-    FACE_BOTTOM,
-    FACE_LAST = FACE_BOTTOM
-};
-
-using FaceVertices = std::array<Vector3, 4>;
-
-const std::array<FaceVertices, FACE_LAST + 1> FACES = {{
-    // Front
-    { Vector3(0, 0, 1), Vector3(0, 1, 1), Vector3(1, 1, 1), Vector3(1, 0, 1) },
-    // Back
-    { Vector3(1, 0, 0), Vector3(1, 1, 0), Vector3(0, 1, 0), Vector3(0, 0, 0) },
-    // Left
-    { Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1), Vector3(0, 0, 1) },
-    // Right
-    { Vector3(1, 0, 1), Vector3(1, 1, 1), Vector3(1, 1, 0), Vector3(1, 0, 0) },
-    // Top
-    { Vector3(0, 1, 1), Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(1, 1, 1) },
-    // Bottom
-    { Vector3(0, 0, 0), Vector3(0, 0, 1), Vector3(1, 0, 1), Vector3(1, 0, 0) }
-}};
-
-const std::array<Vector3, FACE_LAST + 1> FACE_NORMALS = {
-    Vector3(0, 0, 1), Vector3(0, 0, -1), Vector3(-1, 0, 0),  Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0),
-};
-
-constexpr std::array<float, FACE_LAST + 1> FACE_BRIGHTNESS = { 
-    1.0f, 0.6f, 0.85f, 0.75f, 0.9f, 0.8f 
-};
-
-const std::array<Vector2, 4> FACE_UVS = {
-    Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1)  
-};
-
-
 void GDC_Chunk::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_block", "x", "y", "z"), &GDC_Chunk::get_block);
     ClassDB::bind_method(D_METHOD("set_block", "x", "y", "z", "id"), &GDC_Chunk::set_block);
@@ -67,7 +25,55 @@ void GDC_Chunk::_bind_methods() {
     ClassDB::bind_method(D_METHOD("fill", "id"), &GDC_Chunk::fill);
     ClassDB::bind_method(D_METHOD("fill_range", "from", "to", "id"), &GDC_Chunk::fill_range);
 
+    ClassDB::bind_method(D_METHOD("get_sky_light", "x", "y", "z"), &GDC_Chunk::get_sky_light);
+    ClassDB::bind_method(D_METHOD("get_block_light", "x", "y", "z"), &GDC_Chunk::get_block_light);
+
+    ClassDB::bind_method(D_METHOD("serialize"), &GDC_Chunk::serialize);
+    ClassDB::bind_method(D_METHOD("deserialize", "snapshot"), &GDC_Chunk::deserialize);
+
+    ClassDB::bind_method(D_METHOD("is_edit_tracking_enabled"), &GDC_Chunk::is_edit_tracking_enabled);
+    ClassDB::bind_method(D_METHOD("set_edit_tracking_enabled", "enabled"), &GDC_Chunk::set_edit_tracking_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "edit_tracking_enabled"), "set_edit_tracking_enabled", "is_edit_tracking_enabled");
+    ClassDB::bind_method(D_METHOD("has_edits"), &GDC_Chunk::has_edits);
+    ClassDB::bind_method(D_METHOD("take_delta"), static_cast<PackedByteArray (GDC_Chunk::*)()>(&GDC_Chunk::take_delta));
+    ClassDB::bind_method(D_METHOD("apply_delta", "delta"), static_cast<bool (GDC_Chunk::*)(const PackedByteArray &)>(&GDC_Chunk::apply_delta));
+
+    ClassDB::bind_method(D_METHOD("is_modified"), &GDC_Chunk::is_modified);
+    ClassDB::bind_method(D_METHOD("set_modified", "modified"), &GDC_Chunk::set_modified);
+
+    ClassDB::bind_method(D_METHOD("get_block_storage_bytes"), &GDC_Chunk::get_block_storage_bytes);
+    ClassDB::bind_method(D_METHOD("get_palette_size"), &GDC_Chunk::get_palette_size);
+    ClassDB::bind_method(D_METHOD("compact_block_storage"), &GDC_Chunk::compact_block_storage);
+
+    ClassDB::bind_method(D_METHOD("get_meshing_mode"), &GDC_Chunk::get_meshing_mode);
+    ClassDB::bind_method(D_METHOD("set_meshing_mode", "mode"), &GDC_Chunk::set_meshing_mode);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "meshing_mode", PROPERTY_HINT_ENUM, "Naive,Greedy"), "set_meshing_mode", "get_meshing_mode");
+
+    ClassDB::bind_method(D_METHOD("get_vertex_format"), &GDC_Chunk::get_vertex_format);
+    ClassDB::bind_method(D_METHOD("set_vertex_format", "format"), &GDC_Chunk::set_vertex_format);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "vertex_format", PROPERTY_HINT_ENUM, "Standard,Compact"), "set_vertex_format", "get_vertex_format");
+
+    ClassDB::bind_method(D_METHOD("get_lod"), &GDC_Chunk::get_lod);
+    ClassDB::bind_method(D_METHOD("set_lod", "lod"), &GDC_Chunk::set_lod);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "lod", PROPERTY_HINT_RANGE, "0,3"), "set_lod", "get_lod");
+
+    ClassDB::bind_method(D_METHOD("get_mesh_bytes"), &GDC_Chunk::get_mesh_bytes);
+
     ClassDB::bind_method(D_METHOD("generate_mesh"), &GDC_Chunk::generate_mesh);
+    ClassDB::bind_method(D_METHOD("update_mesh"), &GDC_Chunk::update_mesh);
+
+    ClassDB::bind_method(D_METHOD("get_section_non_air_count", "section"), &GDC_Chunk::get_section_non_air_count);
+    ClassDB::bind_method(D_METHOD("is_section_dirty", "section"), &GDC_Chunk::is_section_dirty);
+    ClassDB::bind_method(D_METHOD("mark_section_dirty", "section"), &GDC_Chunk::mark_section_dirty);
+
+    ClassDB::bind_method(D_METHOD("get_section_face_links", "section", "face"), &GDC_Chunk::get_section_face_links);
+    ClassDB::bind_method(D_METHOD("is_section_culled", "section"), &GDC_Chunk::is_section_culled);
+    ClassDB::bind_method(D_METHOD("set_section_culled", "section", "culled"), &GDC_Chunk::set_section_culled);
+
+    ClassDB::bind_method(D_METHOD("is_collision_enabled"), &GDC_Chunk::is_collision_enabled);
+    ClassDB::bind_method(D_METHOD("set_collision_enabled", "enabled"), &GDC_Chunk::set_collision_enabled);
+    ClassDB::bind_method(D_METHOD("update_collision"), &GDC_Chunk::update_collision);
+    ClassDB::bind_method(D_METHOD("get_collision_shape_count"), &GDC_Chunk::get_collision_shape_count);
 
     ClassDB::bind_method(D_METHOD("get_neighbour", "index"), &GDC_Chunk::get_neighbour);
     ClassDB::bind_method(D_METHOD("set_neighbour", "index", "neighbour"), &GDC_Chunk::set_neighbour);
@@ -75,183 +81,688 @@ void GDC_Chunk::_bind_methods() {
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "SIZE", SIZE);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "HEIGHT", HEIGHT);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "BLOCK_COUNT", BLOCK_COUNT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "SECTION_HEIGHT", SECTION_HEIGHT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "SECTION_COUNT", SECTION_COUNT);
 
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "NEIGHBOUR_PX", NEIGHBOUR_PX);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "NEIGHBOUR_NX", NEIGHBOUR_NX);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "NEIGHBOUR_PZ", NEIGHBOUR_PZ);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), "NEIGHBOUR_NZ", NEIGHBOUR_NZ);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "SECTION_FACE_PY", SECTION_FACE_PY);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "SECTION_FACE_NY", SECTION_FACE_NY);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "MAX_LOD", MAX_LOD);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "MAX_LIGHT", MAX_LIGHT);
+
+    BIND_ENUM_CONSTANT(MESHING_NAIVE);
+    BIND_ENUM_CONSTANT(MESHING_GREEDY);
+
+    BIND_ENUM_CONSTANT(VERTEX_FORMAT_STANDARD);
+    BIND_ENUM_CONSTANT(VERTEX_FORMAT_COMPACT);
 }
 
 GDC_Chunk::GDC_Chunk() {
-    std::fill(blocks.begin(), blocks.end(), 0);
     std::fill(p_neighbours.begin(), p_neighbours.end(), nullptr);
+}
 
-    p_mesh_instance = memnew(MeshInstance3D);
-    p_mesh_instance->set_gi_mode(GeometryInstance3D::GI_MODE_DYNAMIC);
-    
-    StandardMaterial3D *p_mat = memnew(StandardMaterial3D);
-    p_mat->set("vertex_color_use_as_albedo", true);
-    p_mesh_instance->set_material_override(p_mat);
-
-    add_child(p_mesh_instance);
+GDC_Chunk::~GDC_Chunk() {
+    for (Section &section : sections) {
+        free_section_instance(section);
+        free_section_collision(section);
+    }
 }
 
 int32_t GDC_Chunk::get_block(const int32_t x, const int32_t y, const int32_t z) const {
-	if (x >= 0 && y >= 0 && z >= 0 && x < SIZE && y < HEIGHT && z < SIZE) {
-		return blocks[(y * SIZE * SIZE) + (z * SIZE) + x];
-    }
-	return -1;
+    return data.get_block(x, y, z);
 }
 
 void GDC_Chunk::set_block(const int32_t x, const int32_t y, const int32_t z, int32_t id) {
-    if (x >= 0 && y >= 0 && z >= 0 && x < SIZE && y < HEIGHT && z < SIZE) {
-		blocks[(y * SIZE * SIZE) + (z * SIZE) + x] = id;
+    if (!data.set_block(x, y, z, id)) {
+        return;
+    }
+
+    sections[y / SECTION_HEIGHT].collision_dirty = true;
+    modified = true;
+    if (edit_tracking_enabled) {
+        track_edit((y * SIZE + z) * SIZE + x);
     }
+    mark_block_dirty(x, y, z);
+    GDC_LightEngine::update_block(data, x, y, z, get_block_table());
 }
 
 void GDC_Chunk::fill(int32_t id) {
-    std::fill(blocks.begin(), blocks.end(), id);
+    data.fill(id);
+    GDC_LightEngine::relight_area(data, get_block_table());
+    for (Section &section : sections) {
+        section.collision_dirty = true;
+    }
+    modified = true;
+    if (edit_tracking_enabled) {
+        edited_all = true;
+    }
+    mark_all_sections_dirty();
+    mark_border_dirty(true, true, true, true, (1u << SECTION_COUNT) - 1);
 }
 
 void GDC_Chunk::fill_range(Vector3i from, Vector3i to, int32_t id) {
-    const int32_t start_x = std::clamp(from.x, 0, SIZE);
-    const int32_t start_y = std::clamp(from.y, 0, HEIGHT);
-    const int32_t start_z = std::clamp(from.z, 0, SIZE);
+    thread_local std::vector<int32_t> changed_blocks;
+    changed_blocks.clear();
+    const uint32_t changed = data.fill_range(from.x, from.y, from.z, to.x, to.y, to.z, id,
+            edit_tracking_enabled ? &changed_blocks : nullptr);
+    if (changed == 0) {
+        return;
+    }
+    modified = true;
+    for (int32_t index : changed_blocks) {
+        track_edit(index);
+    }
+    GDC_LightEngine::relight_area(data, get_block_table());
+    mark_range_dirty(from, to, changed);
+}
 
-    const int32_t end_x = std::clamp(to.x, 0, SIZE);
-    const int32_t end_y = std::clamp(to.y, 0, HEIGHT);
-    const int32_t end_z = std::clamp(to.z, 0, SIZE);
+void GDC_Chunk::get_box(Vector3i from, Vector3i to, int32_t *r_ids, int32_t row_stride, int32_t layer_stride) const {
+    data.get_box(from.x, from.y, from.z, to.x, to.y, to.z, r_ids, row_stride, layer_stride);
+}
 
-    if (start_x >= end_x || start_y >= end_y || start_z >= end_z) {
-        return;
+bool GDC_Chunk::set_box(Vector3i from, Vector3i to, const int32_t *p_ids, int32_t row_stride, int32_t layer_stride) {
+    return set_box(from, to, p_ids, row_stride, layer_stride, true);
+}
+
+bool GDC_Chunk::set_box(Vector3i from, Vector3i to, const int32_t *p_ids, int32_t row_stride, int32_t layer_stride, bool relight) {
+    thread_local std::vector<int32_t> changed_blocks;
+    changed_blocks.clear();
+    const uint32_t changed = data.set_box(from.x, from.y, from.z, to.x, to.y, to.z, p_ids, row_stride, layer_stride,
+            edit_tracking_enabled ? &changed_blocks : nullptr);
+    if (changed == 0) {
+        return false;
+    }
+    modified = true;
+    for (int32_t index : changed_blocks) {
+        track_edit(index);
     }
+    if (relight) {
+        GDC_LightEngine::relight_area(data, get_block_table());
+    }
+    mark_range_dirty(from, to, changed);
+    return true;
+}
 
-    for (int32_t y = start_y; y < end_y; ++y) {
-        for (int32_t z = start_z; z < end_z; ++z) {
-            for (int32_t x = start_x; x < end_x; ++x) {
-                set_block(x, y, z, id);
-            }
+void GDC_Chunk::relight_areas(const std::vector<GDC_Chunk *> &p_chunks) {
+    thread_local std::vector<GDC_ChunkData *> chunk_data;
+    chunk_data.clear();
+    for (GDC_Chunk *p_chunk : p_chunks) {
+        chunk_data.push_back(&p_chunk->data);
+    }
+    GDC_LightEngine::relight_areas(chunk_data.data(), static_cast<int32_t>(chunk_data.size()), get_block_table());
+}
+
+void GDC_Chunk::load_block_data(const int32_t *p_ids, const GDC_BlockTable &p_blocks) {
+    data.load_blocks(p_ids);
+    GDC_LightEngine::relight_area(data, p_blocks);
+    for (Section &section : sections) {
+        section.dirty = true;
+        section.collision_dirty = true;
+    }
+    modified = true;
+}
+
+void GDC_Chunk::store_block_data(int32_t *r_ids) const {
+    data.store_blocks(r_ids);
+}
+
+PackedByteArray GDC_Chunk::serialize() const {
+    thread_local std::vector<uint8_t> bytes;
+    GDC_ChunkCodec::encode_snapshot(data, bytes);
+
+    PackedByteArray snapshot;
+    snapshot.resize(static_cast<int64_t>(bytes.size()));
+    std::copy(bytes.begin(), bytes.end(), snapshot.ptrw());
+    return snapshot;
+}
+
+bool GDC_Chunk::deserialize(const PackedByteArray &p_snapshot) {
+    thread_local std::vector<int32_t> ids;
+    ids.resize(BLOCK_COUNT);
+    ERR_FAIL_COND_V_MSG(!GDC_ChunkCodec::decode_snapshot(p_snapshot.ptr(), p_snapshot.size(), ids.data()), false,
+            "deserialize: malformed chunk snapshot.");
+    set_box(Vector3i(), Vector3i(SIZE, HEIGHT, SIZE), ids.data(), SIZE, SIZE * SIZE);
+    return true;
+}
+
+bool GDC_Chunk::is_edit_tracking_enabled() const {
+    return edit_tracking_enabled;
+}
+
+void GDC_Chunk::set_edit_tracking_enabled(bool p_enabled) {
+    if (edit_tracking_enabled == p_enabled) { return; }
+    edit_tracking_enabled = p_enabled;
+    clear_edits();
+    if (p_enabled) {
+        edited_mask.assign(BLOCK_COUNT / 64, 0);
+    } else {
+        edited_mask = std::vector<uint64_t>();
+        edited_blocks = std::vector<int32_t>();
+    }
+}
+
+bool GDC_Chunk::has_edits() const {
+    return edited_all || !edited_blocks.empty();
+}
+
+// Blocks changed by more than one in this many blocks are sent as a snapshot
+// when that turns out smaller; below it the delta always is.
+static const int32_t DELTA_SNAPSHOT_RATIO = 64;
+
+void GDC_Chunk::take_delta(std::vector<uint8_t> &r_delta) {
+    thread_local std::vector<uint8_t> encoded;
+    r_delta.clear();
+    if (!has_edits()) { return; }
+
+    if (!edited_all) {
+        std::sort(edited_blocks.begin(), edited_blocks.end());
+        GDC_ChunkCodec::encode_delta(data, edited_blocks.data(), static_cast<int32_t>(edited_blocks.size()), encoded);
+        r_delta.push_back(DELTA_BLOCKS);
+        r_delta.insert(r_delta.end(), encoded.begin(), encoded.end());
+    }
+    if (edited_all || static_cast<int32_t>(edited_blocks.size()) > BLOCK_COUNT / DELTA_SNAPSHOT_RATIO) {
+        GDC_ChunkCodec::encode_snapshot(data, encoded);
+        if (r_delta.empty() || encoded.size() + 1 < r_delta.size()) {
+            r_delta.assign(1, DELTA_SNAPSHOT);
+            r_delta.insert(r_delta.end(), encoded.begin(), encoded.end());
+        }
+    }
+    clear_edits();
+}
+
+PackedByteArray GDC_Chunk::take_delta() {
+    thread_local std::vector<uint8_t> bytes;
+    take_delta(bytes);
+
+    PackedByteArray delta;
+    delta.resize(static_cast<int64_t>(bytes.size()));
+    std::copy(bytes.begin(), bytes.end(), delta.ptrw());
+    return delta;
+}
+
+// Replayed edits are not this chunk's own, so they are not tracked: a mirror
+// that records its edits too would otherwise send them straight back.
+bool GDC_Chunk::apply_delta(const uint8_t *p_delta, size_t size) {
+    const bool tracking = edit_tracking_enabled;
+    edit_tracking_enabled = false;
+    const bool applied = replay_delta(p_delta, size);
+    edit_tracking_enabled = tracking;
+    return applied;
+}
+
+bool GDC_Chunk::replay_delta(const uint8_t *p_delta, size_t size) {
+    if (size == 0) { return false; }
+
+    if (p_delta[0] == DELTA_SNAPSHOT) {
+        thread_local std::vector<int32_t> ids;
+        ids.resize(BLOCK_COUNT);
+        if (!GDC_ChunkCodec::decode_snapshot(p_delta + 1, size - 1, ids.data())) { return false; }
+        set_box(Vector3i(), Vector3i(SIZE, HEIGHT, SIZE), ids.data(), SIZE, SIZE * SIZE);
+        return true;
+    }
+
+    thread_local std::vector<int32_t> indices;
+    thread_local std::vector<int32_t> ids;
+    if (p_delta[0] != DELTA_BLOCKS || !GDC_ChunkCodec::decode_delta(p_delta + 1, size - 1, indices, ids)) { return false; }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const int32_t index = indices[i];
+        set_block(index % SIZE, index / (SIZE * SIZE), (index / SIZE) % SIZE, ids[i]);
+    }
+    return true;
+}
+
+bool GDC_Chunk::apply_delta(const PackedByteArray &p_delta) {
+    ERR_FAIL_COND_V_MSG(!apply_delta(p_delta.ptr(), p_delta.size()), false, "apply_delta: malformed chunk delta.");
+    return true;
+}
+
+void GDC_Chunk::track_edit(int32_t index) {
+    uint64_t &word = edited_mask[index >> 6];
+    const uint64_t bit = uint64_t(1) << (index & 63);
+    if (word & bit) { return; }
+    word |= bit;
+    edited_blocks.push_back(index);
+}
+
+void GDC_Chunk::clear_edits() {
+    for (int32_t index : edited_blocks) {
+        edited_mask[index >> 6] = 0;
+    }
+    edited_blocks.clear();
+    edited_all = false;
+}
+
+int32_t GDC_Chunk::get_sky_light(int32_t x, int32_t y, int32_t z) const {
+    return data.get_light(x, y, z) >> 4;
+}
+
+int32_t GDC_Chunk::get_block_light(int32_t x, int32_t y, int32_t z) const {
+    return data.get_light(x, y, z) & 0x0f;
+}
+
+void GDC_Chunk::stitch_light() {
+    GDC_LightEngine::stitch_chunk(data, get_block_table());
+}
+
+bool GDC_Chunk::take_light_changes() {
+    const uint32_t changed = data.take_light_dirty_sections();
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (changed & (1u << i)) {
+            sections[i].dirty = true;
         }
     }
+    return changed != 0;
+}
+
+const GDC_BlockTable &GDC_Chunk::get_block_table() {
+    static const GDC_BlockTable empty;
+    GDC_BlockRegistry *reg = GDC_BlockRegistry::get_singleton();
+    return reg != nullptr ? reg->get_block_table() : empty;
+}
+
+bool GDC_Chunk::is_modified() const {
+    return modified;
+}
+
+void GDC_Chunk::set_modified(bool p_modified) {
+    modified = p_modified;
+}
+
+int64_t GDC_Chunk::get_block_storage_bytes() const {
+    return data.get_storage_bytes();
+}
+
+// Total palette entries across all sections.
+int32_t GDC_Chunk::get_palette_size() const {
+    return data.get_palette_size();
+}
+
+void GDC_Chunk::compact_block_storage() {
+    data.compact();
+}
+
+GDC_Chunk::MeshingMode GDC_Chunk::get_meshing_mode() const {
+    return meshing_mode;
+}
+
+void GDC_Chunk::set_meshing_mode(MeshingMode p_mode) {
+    meshing_mode = p_mode;
+}
+
+GDC_Chunk::VertexFormat GDC_Chunk::get_vertex_format() const {
+    return vertex_format;
+}
+
+void GDC_Chunk::set_vertex_format(VertexFormat p_format) {
+    vertex_format = p_format;
+}
+
+int32_t GDC_Chunk::get_lod() const {
+    return lod;
+}
+
+void GDC_Chunk::set_lod(int32_t p_lod) {
+    p_lod = CLAMP(p_lod, 0, MAX_LOD);
+    if (lod == p_lod) { return; }
+
+    lod = p_lod;
+    if (lod > 0) {
+        set_collision_enabled(false);
+    }
+    mark_all_sections_dirty();
+}
+
+int64_t GDC_Chunk::get_mesh_bytes() const {
+    int64_t total = 0;
+    for (const Section &section : sections) {
+        total += section.mesh_bytes;
+    }
+    return total;
 }
 
 void GDC_Chunk::generate_mesh() {
-    PackedVector3Array vertices;
-    PackedVector3Array normals;
-    PackedColorArray colors;
-    PackedVector2Array uvs;
-    PackedInt32Array indices;
+    mark_all_sections_dirty();
+    update_mesh();
+}
 
-    std::vector<Color> color_table;
-    if (GDC_BlockRegistry *reg = GDC_BlockRegistry::get_singleton()) {
-        const int32_t count = reg->get_block_count();
-        color_table.resize(count + 1, Color(1.0f, 0.0f, 0.0f, 1.0f));
-        for (int32_t i = 1; i <= count; ++i) {
-            Ref<GDC_BlockData> data = reg->get_block_by_id(i);
-            if (data.is_valid()) {
-                color_table[i] = data->get_color();
+// Rebuilds only the sections whose blocks, or whose neighbours' border blocks,
+// changed since they were last meshed.
+void GDC_Chunk::update_mesh() {
+    take_light_changes();
+
+    thread_local GDC_ChunkSnapshot snapshot;
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (!sections[i].dirty) {
+            continue;
+        }
+        clear_section_dirty(i);
+
+        GDC_MeshBuffers buffers;
+        if (!is_section_skippable(i)) {
+            capture_section_snapshot(i, snapshot);
+            const uint64_t start = GDC_PerfStats::get_ticks_usec();
+            GDC_ChunkMesher::build(snapshot, buffers);
+            if (p_perf_stats) {
+                p_perf_stats->add_mesh(GDC_PerfStats::get_ticks_usec() - start, buffers.get_vertex_count());
             }
         }
+        apply_section_mesh(i, buffers);
     }
+}
 
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int z = 0; z < SIZE; ++z) {
-            for (int x = 0; x < SIZE; ++x) {
-                const int32_t id = get_block(x, y, z);
-                if (id <= 0) { continue; }
-
-                const Color block_color = (id < static_cast<int32_t>(color_table.size()))
-                    ? color_table[id]
-                    : Color(1.0f, 0.0f, 0.0f, 1.0f);
-                const Vector3 offset(x, y, z);
-
-                for (size_t i = 0; i < FACE_LAST + 1; ++i) {
-                    const Vector3 face_normal = FACE_NORMALS[i];
-
-                    const int32_t nx = x + int(face_normal.x);
-                    const int32_t ny = y + int(face_normal.y);
-                    const int32_t nz = z + int(face_normal.z);
-                    if (get_block_including_neighbours(nx, ny, nz) > 0) {
-                        continue;
-                    }
-
-                    const FaceVertices face_vertices = FACES[i];
-                    const float brightness = FACE_BRIGHTNESS[i];
-                    const Color shaded_color = Color(block_color.r * brightness, block_color.g * brightness, block_color.b * brightness);
-                    
-                    const int32_t base = vertices.size();
-
-                    for (int j = 0; j < 4; ++j) {
-                        vertices.append(offset + face_vertices[j]);
-                        normals.append(face_normal);
-                        colors.append(shaded_color);
-                        uvs.append(FACE_UVS[j]);
-                    }
-                    
-                    indices.append_array({base, base + 1, base + 2, base, base + 2, base + 3});
-                }
-            }
+int32_t GDC_Chunk::get_section_non_air_count(int32_t section) const {
+    if (section >= 0 && section < SECTION_COUNT) {
+        return data.get_section_non_air_count(section);
+    }
+    return 0;
+}
+
+bool GDC_Chunk::is_section_dirty(int32_t section) const {
+    if (section >= 0 && section < SECTION_COUNT) {
+        return sections[section].dirty;
+    }
+    return false;
+}
+
+bool GDC_Chunk::has_dirty_sections() const {
+    return std::any_of(sections.begin(), sections.end(), [](const Section &section) { return section.dirty; });
+}
+
+void GDC_Chunk::mark_section_dirty(int32_t section) {
+    if (section >= 0 && section < SECTION_COUNT) {
+        sections[section].dirty = true;
+    }
+}
+
+// Called when a section is captured for meshing, so edits made while the mesh
+// is being built leave it dirty again.
+void GDC_Chunk::clear_section_dirty(int32_t section) {
+    if (section >= 0 && section < SECTION_COUNT) {
+        sections[section].dirty = false;
+    }
+}
+
+void GDC_Chunk::mark_all_sections_dirty() {
+    for (Section &section : sections) {
+        section.dirty = true;
+    }
+}
+
+int32_t GDC_Chunk::get_section_face_links(int32_t section, int32_t face) const {
+    if (section >= 0 && section < SECTION_COUNT && face >= 0 && face < SECTION_FACE_COUNT) {
+        return sections[section].face_links[face];
+    }
+    return 0;
+}
+
+bool GDC_Chunk::is_section_culled(int32_t section) const {
+    if (section >= 0 && section < SECTION_COUNT) {
+        return sections[section].culled;
+    }
+    return false;
+}
+
+void GDC_Chunk::set_section_culled(int32_t section, bool p_culled) {
+    if (section < 0 || section >= SECTION_COUNT) { return; }
+
+    Section &r_section = sections[section];
+    if (r_section.culled == p_culled) { return; }
+    r_section.culled = p_culled;
+    if (r_section.instance.is_valid()) {
+        RenderingServer::get_singleton()->instance_set_visible(r_section.instance, visible && !p_culled);
+    }
+}
+
+bool GDC_Chunk::is_section_skippable(int32_t section) const {
+    if (data.get_section_non_air_count(section) == 0) {
+        return true;
+    }
+    const GDC_BlockTable &blocks = get_block_table();
+    if (!data.is_section_opaque(section, blocks)) {
+        return false;
+    }
+
+    // The world's top and bottom faces are exposed, as is the border with a
+    // missing neighbour chunk.
+    if (section == 0 || section == SECTION_COUNT - 1) {
+        return false;
+    }
+    if (!data.is_section_opaque(section - 1, blocks) || !data.is_section_opaque(section + 1, blocks)) {
+        return false;
+    }
+    for (const GDC_Chunk *p_neighbour : p_neighbours) {
+        if (p_neighbour == nullptr || !p_neighbour->data.is_section_opaque(section, blocks)) {
+            return false;
         }
     }
+    return true;
+}
 
-    Array arrays;
-    arrays.resize(ArrayMesh::ARRAY_MAX);
+void GDC_Chunk::capture_section_snapshot(int32_t section, GDC_ChunkSnapshot &r_snapshot) const {
+    r_snapshot.meshing_mode = meshing_mode;
+    r_snapshot.vertex_format = vertex_format;
 
-    arrays[ArrayMesh::ARRAY_VERTEX] = vertices;
-    arrays[ArrayMesh::ARRAY_INDEX]  = indices;
-    arrays[ArrayMesh::ARRAY_NORMAL] = normals;
-    arrays[ArrayMesh::ARRAY_TEX_UV] = uvs;
-    arrays[ArrayMesh::ARRAY_COLOR]  = colors;
+    GDC_ChunkData::Neighbours neighbours;
+    for (int32_t i = 0; i < 4; ++i) {
+        const GDC_Chunk *p_neighbour = get_seam_neighbour(i);
+        neighbours[i] = p_neighbour != nullptr ? &p_neighbour->data : nullptr;
+    }
+    // Copy-assigning reuses the snapshot's storage once it is large enough.
+    r_snapshot.blocks = get_block_table();
+    if (vertex_format == VERTEX_FORMAT_COMPACT && r_snapshot.blocks.get_count() > COMPACT_MAX_BLOCK_ID + 1) {
+        WARN_PRINT_ONCE("GDC_Chunk: block ids above 4095 do not fit compact vertices; meshing in the standard format.");
+        r_snapshot.vertex_format = VERTEX_FORMAT_STANDARD;
+    }
+    data.capture_section(section, lod, neighbours, r_snapshot.blocks, r_snapshot.cells);
+    if (GDC_BlockRegistry *reg = GDC_BlockRegistry::get_singleton()) {
+        r_snapshot.color_table = reg->get_color_table();
+        r_snapshot.layer_table = reg->get_layer_table();
+    } else {
+        r_snapshot.color_table.clear();
+        r_snapshot.layer_table.clear();
+    }
+}
+
+void GDC_Chunk::apply_section_mesh(int32_t section_index, const GDC_MeshBuffers &p_buffers) {
+    GDC_PerfScope scope(p_perf_stats, GDC_PerfStats::TIMER_MESH_APPLY);
+    Section &section = sections[section_index];
+    section.mesh_bytes = p_buffers.get_memory_usage();
+
+    // Skipped sections are never built, so their links follow from the fill.
+    if (data.is_section_opaque(section_index, get_block_table())) {
+        section.face_links = GDC_ChunkData::make_face_links(0);
+    } else if (data.get_section_non_air_count(section_index) == 0) {
+        section.face_links = GDC_ChunkData::make_face_links(ALL_SECTION_FACES);
+    } else {
+        section.face_links = p_buffers.face_links;
+    }
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+    if (p_buffers.is_empty()) {
+        // The mesh and instance stay around for the next non-empty build.
+        if (section.mesh.is_valid() && section.vertex_count > 0) {
+            rs->mesh_clear(section.mesh);
+            section.vertex_count = 0;
+            section.index_data = PackedByteArray();
+        }
+        return;
+    }
 
-    ArrayMesh *p_arr_mesh = memnew(ArrayMesh);
-    if (vertices.size() > 0) {
-        p_arr_mesh->add_surface_from_arrays(Mesh::PrimitiveType::PRIMITIVE_TRIANGLES, arrays);
+    if (!section.instance.is_valid()) {
+        create_section_instance(section_index);
     }
-    p_mesh_instance->set_mesh(p_arr_mesh);
 
-    free_static_bodies();
+    Array arrays;
+    arrays.resize(RenderingServer::ARRAY_MAX);
+    arrays[RenderingServer::ARRAY_INDEX]  = p_buffers.indices;
+
+    if (p_buffers.is_compact()) {
+        // A 2D vertex array is the whole compact vertex. Its raw values are
+        // no positions, so culling relies on the section's custom AABB.
+        arrays[RenderingServer::ARRAY_VERTEX] = p_buffers.packed;
+    } else {
+        arrays[RenderingServer::ARRAY_VERTEX]  = p_buffers.vertices;
+        arrays[RenderingServer::ARRAY_NORMAL]  = p_buffers.normals;
+        arrays[RenderingServer::ARRAY_TEX_UV]  = p_buffers.uvs;
+        arrays[RenderingServer::ARRAY_TEX_UV2] = p_buffers.uv2s;
+        arrays[RenderingServer::ARRAY_COLOR]   = p_buffers.colors;
+    }
+    const Dictionary surface = rs->mesh_create_surface_data_from_arrays(
+            RenderingServer::PRIMITIVE_TRIANGLES, arrays);
+
+    // Recolouring (a light or block change that keeps the same faces) only
+    // rewrites the vertex buffers of the existing surface; anything else
+    // replaces the surface of the same mesh.
+    const uint64_t format = static_cast<uint64_t>(surface["format"]);
+    const int32_t vertex_count = p_buffers.get_vertex_count();
+    const PackedByteArray index_data = surface["index_data"];
+    if (section.vertex_count == vertex_count && section.surface_format == format && section.index_data == index_data) {
+        rs->mesh_surface_update_vertex_region(section.mesh, 0, 0, surface["vertex_data"]);
+        const PackedByteArray attribute_data = surface["attribute_data"];
+        if (!attribute_data.is_empty()) {
+            rs->mesh_surface_update_attribute_region(section.mesh, 0, 0, attribute_data);
+        }
+    } else {
+        rs->mesh_clear(section.mesh);
+        rs->mesh_add_surface(section.mesh, surface);
+        section.surface_format = format;
+        section.vertex_count = vertex_count;
+        section.index_data = index_data;
+    }
 
-    if (vertices.size() > 0) {
-        add_collision_shape(p_arr_mesh);
+    // Every chunk shares the registry's materials.
+    if (GDC_BlockRegistry *reg = GDC_BlockRegistry::get_singleton()) {
+        const Ref<ShaderMaterial> material = p_buffers.is_compact() ? reg->get_compact_material() : reg->get_standard_material();
+        rs->instance_geometry_set_material_override(section.instance, material.is_valid() ? material->get_rid() : RID());
     }
 }
 
-int32_t GDC_Chunk::get_block_including_neighbours(const int32_t x, const int32_t y, const int32_t z) const {
-    if (x >= 0 && y >= 0 && z >= 0 && x < SIZE && y < HEIGHT && z < SIZE) {
-		return get_block(x, y, z);
+void GDC_Chunk::reset() {
+    set_world(RID(), RID());
+    set_transform(Transform3D());
+    set_visible(true);
+
+    data.fill(0);
+    data.fill_light(GDC_ChunkData::OPEN_SKY_LIGHT);
+    data.take_light_dirty_sections();
+    for (int32_t i = 0; i < 4; ++i) {
+        set_neighbour(i, nullptr);
+    }
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        Section &section = sections[i];
+        if (section.vertex_count > 0) {
+            rs->mesh_clear(section.mesh);
+        }
+        section.vertex_count = 0;
+        section.index_data = PackedByteArray();
+        section.mesh_bytes = 0;
+        section.dirty = true;
+        section.collision_dirty = true;
+        clear_section_collision(section);
+        section.face_links = GDC_ChunkData::make_face_links(ALL_SECTION_FACES);
+        set_section_culled(i, false);
     }
 
-    if (y < 0 || y >= HEIGHT) { return 0; }
+    meshing_mode = MESHING_GREEDY;
+    vertex_format = VERTEX_FORMAT_STANDARD;
+    lod = 0;
+    modified = false;
+    set_edit_tracking_enabled(false);
+    collision_enabled = false;
+    p_perf_stats = nullptr;
+}
 
-    if (x < 0) {
-        if (p_neighbours[NEIGHBOUR_NX] != nullptr) {
-            return p_neighbours[NEIGHBOUR_NX]->get_block(x + SIZE, y, z);
+void GDC_Chunk::set_world(const RID &p_scenario, const RID &p_space) {
+    RenderingServer *rs = RenderingServer::get_singleton();
+    PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+    scenario = p_scenario;
+    space = p_space;
+    for (const Section &section : sections) {
+        if (section.instance.is_valid()) {
+            rs->instance_set_scenario(section.instance, scenario);
+        }
+        if (section.body.is_valid()) {
+            ps->body_set_space(section.body, space);
         }
-        return 0;
     }
+}
 
-    if (x >= SIZE) {
-        if (p_neighbours[NEIGHBOUR_PX] != nullptr) {
-            return p_neighbours[NEIGHBOUR_PX]->get_block(x - SIZE, y, z);
+void GDC_Chunk::set_transform(const Transform3D &p_transform) {
+    RenderingServer *rs = RenderingServer::get_singleton();
+    PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+    transform = p_transform;
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (sections[i].instance.is_valid()) {
+            rs->instance_set_transform(sections[i].instance, get_section_transform(i));
+        }
+        if (sections[i].body.is_valid()) {
+            ps->body_set_state(sections[i].body, PhysicsServer3D::BODY_STATE_TRANSFORM, get_section_transform(i));
         }
-        return 0;
     }
+}
+
+void GDC_Chunk::set_visible(bool p_visible) {
+    if (visible == p_visible) { return; }
 
-    if (z < 0) {
-        if (p_neighbours[NEIGHBOUR_NZ] != nullptr) {
-            return p_neighbours[NEIGHBOUR_NZ]->get_block(x, y, z + SIZE);
+    visible = p_visible;
+    for (const Section &section : sections) {
+        if (section.instance.is_valid()) {
+            RenderingServer::get_singleton()->instance_set_visible(section.instance, visible && !section.culled);
         }
-        return 0;
     }
+}
+
+bool GDC_Chunk::is_collision_enabled() const {
+    return collision_enabled;
+}
+
+void GDC_Chunk::set_collision_enabled(bool p_enabled) {
+    if (collision_enabled == p_enabled) { return; }
 
-    if (z >= SIZE) {
-        if (p_neighbours[NEIGHBOUR_PZ] != nullptr) {
-            return p_neighbours[NEIGHBOUR_PZ]->get_block(x, y, z - SIZE);
+    collision_enabled = p_enabled;
+    GDC_PerfScope scope(p_enabled ? nullptr : p_perf_stats, GDC_PerfStats::TIMER_COLLISION_FREE);
+    for (Section &section : sections) {
+        if (!p_enabled) {
+            clear_section_collision(section);
         }
-        return 0;
+        section.collision_dirty = true;
     }
+}
+
+void GDC_Chunk::update_collision() {
+    if (!collision_enabled || lod > 0 || !space.is_valid()) { return; }
 
-	return 0;
+    GDC_PerfScope scope(p_perf_stats, GDC_PerfStats::TIMER_COLLISION_BUILD);
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (sections[i].collision_dirty) {
+            update_section_collision(i);
+        }
+    }
+}
+
+int32_t GDC_Chunk::get_collision_shape_count() const {
+    int32_t count = 0;
+    for (const Section &section : sections) {
+        count += section.shape_count;
+    }
+    return count;
+}
+
+
+// A neighbour meshed at another LOD reads as air, so both sides of the seam keep
+// their border faces. These skirts cover the gaps where the coarse and the fine
+// surfaces do not line up.
+const GDC_Chunk *GDC_Chunk::get_seam_neighbour(int32_t index) const {
+    const GDC_Chunk *p_neighbour = p_neighbours[index];
+    if (p_neighbour != nullptr && p_neighbour->lod == lod) {
+        return p_neighbour;
+    }
+    return nullptr;
 }
 
 GDC_Chunk *GDC_Chunk::get_neighbour(int32_t index) const {
@@ -264,29 +775,173 @@ GDC_Chunk *GDC_Chunk::get_neighbour(int32_t index) const {
 void GDC_Chunk::set_neighbour(int32_t index, GDC_Chunk *neighbour) {
     if (index >= 0 && index < 4) {
         p_neighbours[index] = neighbour;
+        data.set_neighbour(index, neighbour != nullptr ? &neighbour->data : nullptr);
+    }
+}
+
+// Flags the block's section for remeshing, plus any section above, below or
+// beside it (in a neighbour chunk) whose exposed faces depend on this block.
+void GDC_Chunk::mark_block_dirty(int32_t x, int32_t y, int32_t z) {
+    const int32_t section = y / SECTION_HEIGHT;
+    uint32_t border_sections = 1u << section;
+    if (y % SECTION_HEIGHT == 0 && section > 0) {
+        border_sections |= 1u << (section - 1);
+    }
+    if (y % SECTION_HEIGHT == SECTION_HEIGHT - 1 && section < SECTION_COUNT - 1) {
+        border_sections |= 1u << (section + 1);
+    }
+
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (border_sections & (1u << i)) { sections[i].dirty = true; }
     }
+    mark_border_dirty(x == 0, x == SIZE - 1, z == 0, z == SIZE - 1, border_sections);
 }
 
-void GDC_Chunk::free_static_bodies() {
-    Array children = get_children();
-    for (int i = 0; i < children.size(); ++i) {
-        Node *p_child = Object::cast_to<Node>(children[i]);
-        if (!p_child) { continue; }
+// Remeshes whatever borders the range touches in each changed section.
+void GDC_Chunk::mark_range_dirty(Vector3i from, Vector3i to, uint32_t changed_sections) {
+    uint32_t border_sections = 0;
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (!(changed_sections & (1u << i))) { continue; }
+
+        sections[i].dirty = true;
+        sections[i].collision_dirty = true;
+        border_sections |= 1u << i;
+        if (from.y <= i * SECTION_HEIGHT && i > 0) {
+            border_sections |= 1u << (i - 1);
+        }
+        if (to.y >= (i + 1) * SECTION_HEIGHT && i < SECTION_COUNT - 1) {
+            border_sections |= 1u << (i + 1);
+        }
+    }
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        if (border_sections & (1u << i)) { sections[i].dirty = true; }
+    }
+    mark_border_dirty(from.x <= 0, to.x >= SIZE, from.z <= 0, to.z >= SIZE, border_sections);
+}
 
-        if (Object::cast_to<StaticBody3D>(p_child)) {
-            p_child->queue_free();
+// Sections capture a one-cell border that includes the cells one section up and
+// down across each chunk face and the corner columns of the diagonal chunks, and
+// their AO reads all of it. So an edit on a chunk border dirties `p_sections`
+// (the edited sections and those whose border ring reaches them) in every
+// neighbour it touches, diagonal ones included.
+void GDC_Chunk::mark_border_dirty(bool p_nx, bool p_px, bool p_nz, bool p_pz, uint32_t p_sections) {
+    auto mark = [p_sections](GDC_Chunk *p_chunk) {
+        if (p_chunk == nullptr) { return; }
+        for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+            if (p_sections & (1u << i)) { p_chunk->sections[i].dirty = true; }
         }
+    };
+    // The diagonal chunk through either neighbour's own link.
+    auto diagonal = [this](int32_t side_x, int32_t side_z) -> GDC_Chunk * {
+        if (p_neighbours[side_x] != nullptr && p_neighbours[side_x]->p_neighbours[side_z] != nullptr) {
+            return p_neighbours[side_x]->p_neighbours[side_z];
+        }
+        return p_neighbours[side_z] != nullptr ? p_neighbours[side_z]->p_neighbours[side_x] : nullptr;
+    };
+
+    if (p_nx) { mark(p_neighbours[NEIGHBOUR_NX]); }
+    if (p_px) { mark(p_neighbours[NEIGHBOUR_PX]); }
+    if (p_nz) { mark(p_neighbours[NEIGHBOUR_NZ]); }
+    if (p_pz) { mark(p_neighbours[NEIGHBOUR_PZ]); }
+    if (p_nx && p_nz) { mark(diagonal(NEIGHBOUR_NX, NEIGHBOUR_NZ)); }
+    if (p_nx && p_pz) { mark(diagonal(NEIGHBOUR_NX, NEIGHBOUR_PZ)); }
+    if (p_px && p_nz) { mark(diagonal(NEIGHBOUR_PX, NEIGHBOUR_NZ)); }
+    if (p_px && p_pz) { mark(diagonal(NEIGHBOUR_PX, NEIGHBOUR_PZ)); }
+}
+
+void GDC_Chunk::update_section_collision(int32_t section_index) {
+    Section &section = sections[section_index];
+    section.collision_dirty = false;
+
+    thread_local std::vector<int32_t> ids(SECTION_VOLUME);
+    thread_local std::vector<GDC_CollisionBox> boxes;
+    boxes.clear();
+    if (data.get_section_non_air_count(section_index) > 0) {
+        data.get_section_storage(section_index).get_range(0, SECTION_VOLUME, ids.data());
+        GDC_CollisionBuilder::build_boxes(ids.data(), get_block_table(), boxes);
+    }
+
+    if (boxes.empty() && !section.body.is_valid()) {
+        return;
+    }
+
+    PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+    if (!section.body.is_valid()) {
+        section.body = ps->body_create();
+        ps->body_set_mode(section.body, PhysicsServer3D::BODY_MODE_STATIC);
+        ps->body_attach_object_instance_id(section.body, get_instance_id());
+        ps->body_set_space(section.body, space);
+        ps->body_set_state(section.body, PhysicsServer3D::BODY_STATE_TRANSFORM, get_section_transform(section_index));
     }
+
+    // The body stays in the space; only its shape list is rebuilt.
+    ps->body_clear_shapes(section.body);
+    while (section.shapes.size() < boxes.size()) {
+        section.shapes.push_back(ps->box_shape_create());
+    }
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const Vector3 half_extents = Vector3(boxes[i].size) * 0.5f;
+        ps->shape_set_data(section.shapes[i], half_extents);
+        ps->body_add_shape(section.body, section.shapes[i], Transform3D(Basis(), Vector3(boxes[i].position) + half_extents));
+    }
+    section.shape_count = static_cast<int32_t>(boxes.size());
 }
 
-void GDC_Chunk::add_collision_shape(ArrayMesh *p_arr_mesh) {
-    StaticBody3D *p_static_body = memnew(StaticBody3D);
-    add_child(p_static_body);
+void GDC_Chunk::create_section_instance(int32_t section_index) {
+    RenderingServer *rs = RenderingServer::get_singleton();
+    Section &section = sections[section_index];
+    section.mesh = rs->mesh_create();
+    // Updated vertex regions do not refresh the mesh's AABB, and no face ever
+    // leaves its section.
+    rs->mesh_set_custom_aabb(section.mesh, AABB(Vector3(), Vector3(SIZE, SECTION_HEIGHT, SIZE)));
+
+    section.instance = rs->instance_create();
+    rs->instance_set_base(section.instance, section.mesh);
+    rs->instance_geometry_set_flag(section.instance, RenderingServer::INSTANCE_FLAG_USE_DYNAMIC_GI, true);
+    // Lighting is baked into the vertices; the terrain stays out of shadow maps.
+    rs->instance_geometry_set_cast_shadows_setting(section.instance, RenderingServer::SHADOW_CASTING_SETTING_OFF);
+    rs->instance_set_transform(section.instance, get_section_transform(section_index));
+    rs->instance_set_visible(section.instance, visible && !section.culled);
+    rs->instance_set_scenario(section.instance, scenario);
+}
+
+void GDC_Chunk::free_section_instance(Section &r_section) {
+    RenderingServer *rs = RenderingServer::get_singleton();
+    if (r_section.instance.is_valid()) {
+        rs->free_rid(r_section.instance);
+        r_section.instance = RID();
+    }
+    if (r_section.mesh.is_valid()) {
+        rs->free_rid(r_section.mesh);
+        r_section.mesh = RID();
+    }
+    r_section.vertex_count = 0;
+    r_section.index_data = PackedByteArray();
+}
 
-    CollisionShape3D *p_collision_shape = memnew(CollisionShape3D);
+Transform3D GDC_Chunk::get_section_transform(int32_t section_index) const {
+    return transform * Transform3D(Basis(), Vector3(0, section_index * SECTION_HEIGHT, 0));
+}
 
-    Ref<ConcavePolygonShape3D> shape = p_arr_mesh->create_trimesh_shape();
-    p_collision_shape->set_shape(shape);
+// The body stays in its space without shapes, which costs the physics server
+// next to nothing, and the shapes wait in `shapes` for the next rebuild.
+void GDC_Chunk::clear_section_collision(Section &r_section) {
+    if (r_section.shape_count > 0) {
+        PhysicsServer3D::get_singleton()->body_clear_shapes(r_section.body);
+        r_section.shape_count = 0;
+    }
+}
 
-    p_static_body->add_child(p_collision_shape);
+void GDC_Chunk::free_section_collision(Section &r_section) {
+    PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+    if (r_section.body.is_valid()) {
+        ps->free_rid(r_section.body);
+        r_section.body = RID();
+    }
+    for (const RID &shape : r_section.shapes) {
+        ps->free_rid(shape);
+    }
+    r_section.shapes.clear();
+    r_section.shape_count = 0;
 }
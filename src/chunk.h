@@ -1,53 +1,275 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
-#include <godot_cpp/classes/node3d.hpp>
-#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+#include "core/chunk_data.h"
+#include "core/light_engine.h"
+#include "perf_stats.h"
 
 namespace godot {
 
-class GDC_Chunk : public Node3D {
-	GDCLASS(GDC_Chunk, Node3D)
+struct GDC_ChunkSnapshot;
+struct GDC_MeshBuffers;
+
+// One chunk column: its blocks plus the render instances and collision bodies
+// of its sections. It is a plain Object rather than a Node, owned by the
+// GDC_World it is registered with: meshes and bodies live directly on the
+// RenderingServer and PhysicsServer3D, placed with set_world() and
+// set_transform(), so thousands of chunks add nothing to the scene tree.
+class GDC_Chunk : public Object {
+	GDCLASS(GDC_Chunk, Object)
 
 public:
-    static const int32_t SIZE = 16;
-    static const int32_t HEIGHT = 128;
-    static const int32_t BLOCK_COUNT = SIZE * SIZE * HEIGHT;
+    // Layout constants live with the engine-independent block data.
+    static const int32_t SIZE = GDC_ChunkData::SIZE;
+    static const int32_t HEIGHT = GDC_ChunkData::HEIGHT;
+    static const int32_t BLOCK_COUNT = GDC_ChunkData::BLOCK_COUNT;
+
+    static const int32_t SECTION_HEIGHT = GDC_ChunkData::SECTION_HEIGHT;
+    static const int32_t SECTION_COUNT = GDC_ChunkData::SECTION_COUNT;
+    static const int32_t SECTION_VOLUME = GDC_ChunkData::SECTION_VOLUME;
+
+    static const int32_t NEIGHBOUR_PX = GDC_ChunkData::NEIGHBOUR_PX;
+    static const int32_t NEIGHBOUR_NX = GDC_ChunkData::NEIGHBOUR_NX;
+    static const int32_t NEIGHBOUR_PZ = GDC_ChunkData::NEIGHBOUR_PZ;
+    static const int32_t NEIGHBOUR_NZ = GDC_ChunkData::NEIGHBOUR_NZ;
 
-    static const int32_t NEIGHBOUR_PX = 0; // +X neighbour
-    static const int32_t NEIGHBOUR_NX = 1; // -X neighbour
-    static const int32_t NEIGHBOUR_PZ = 2; // +Z neighbour
-    static const int32_t NEIGHBOUR_NZ = 3; // -Z neighbour
+    static const int32_t SECTION_FACE_PY = GDC_ChunkData::SECTION_FACE_PY;
+    static const int32_t SECTION_FACE_NY = GDC_ChunkData::SECTION_FACE_NY;
+    static const int32_t SECTION_FACE_COUNT = GDC_ChunkData::SECTION_FACE_COUNT;
+    static const uint8_t ALL_SECTION_FACES = GDC_ChunkData::ALL_SECTION_FACES;
+    using FaceLinks = GDC_ChunkData::FaceLinks;
+
+    static const int32_t MAX_LOD = GDC_ChunkData::MAX_LOD;
+    static const int32_t MAX_LIGHT = GDC_ChunkData::MAX_LIGHT;
+
+    enum MeshingMode {
+        MESHING_NAIVE,  // one quad per exposed block face
+        MESHING_GREEDY, // coplanar faces of the same block merged into rectangles
+    };
+
+    enum VertexFormat {
+        VERTEX_FORMAT_STANDARD, // float position, normal, colour and UV per vertex
+        VERTEX_FORMAT_COMPACT,  // 8 bytes of packed integers, decoded by the voxel shader
+    };
+    // Compact vertices hold the block id in 12 bits (see GDC_MeshBuffers).
+    static const int32_t COMPACT_MAX_BLOCK_ID = 4095;
 
 	std::array<GDC_Chunk *, 4> p_neighbours;
 
 private:
-	std::array<int32_t, BLOCK_COUNT> blocks;
-	MeshInstance3D *p_mesh_instance;
+    // The engine-side state of a 16-block-high slice of the column: its mesh and
+    // collision, so edits and empty space only cost what they touch.
+    struct Section {
+        int64_t mesh_bytes = 0;
+        bool dirty = true;
+        bool collision_dirty = true;
+        RID mesh;     // RenderingServer mesh and the instance showing it, created
+        RID instance; // on the first non-empty mesh and kept until the chunk dies
+        // The surface last uploaded, so a remesh with the same layout and
+        // triangles only rewrites the vertex data.
+        uint64_t surface_format = 0;
+        int32_t vertex_count = 0;
+        PackedByteArray index_data;
+        RID body; // static PhysicsServer3D body, created on first use
+        std::vector<RID> shapes; // box shapes, reused across rebuilds
+        int32_t shape_count = 0; // how many of `shapes` the body holds
+        FaceLinks face_links = GDC_ChunkData::make_face_links(ALL_SECTION_FACES); // from the last mesh
+        bool culled = false; // hidden by the world's visibility pass
+    };
+
+    GDC_ChunkData data;
+	std::array<Section, SECTION_COUNT> sections;
+    MeshingMode meshing_mode = MESHING_GREEDY;
+    VertexFormat vertex_format = VERTEX_FORMAT_STANDARD;
+    int32_t lod = 0;
+    bool modified = false;
+    bool edit_tracking_enabled = false;
+    bool edited_all = false;             // fill() changed everything at once
+    std::vector<uint64_t> edited_mask;   // one bit per block, allocated while tracking
+    std::vector<int32_t> edited_blocks;  // the set bits of edited_mask, unordered
+    bool collision_enabled = false;
+    GDC_PerfStats *p_perf_stats = nullptr;
+
+    RID scenario; // where section instances are drawn, invalid while detached
+    RID space;    // where section bodies collide, likewise
+    Transform3D transform;
+    bool visible = true;
 
 protected:
 	static void _bind_methods();
 
 public:
 	GDC_Chunk();
-	~GDC_Chunk() override = default;
+	~GDC_Chunk() override;
 
 	int32_t get_block(int32_t x, int32_t y, int32_t z) const;
     void set_block(int32_t x, int32_t y, int32_t z, int32_t id);
 
     void fill(int32_t id);
     void fill_range(Vector3i from, Vector3i to, int32_t id);
+
+    // Copy the blocks in [from, to), which must lie inside the chunk, to or
+    // from ids in y, z, x order with rows (z) and layers (y) the given strides
+    // apart. Writing relights like fill_range() and returns false if no block
+    // changed. Edits spanning several chunks pass `relight` = false and relight
+    // every changed chunk together with relight_areas() afterwards.
+    void get_box(Vector3i from, Vector3i to, int32_t *r_ids, int32_t row_stride, int32_t layer_stride) const;
+    bool set_box(Vector3i from, Vector3i to, const int32_t *p_ids, int32_t row_stride, int32_t layer_stride);
+    bool set_box(Vector3i from, Vector3i to, const int32_t *p_ids, int32_t row_stride, int32_t layer_stride, bool relight);
+    // GDC_LightEngine::relight_areas() over the chunks' block data.
+    static void relight_areas(const std::vector<GDC_Chunk *> &p_chunks);
+
+    // Bulk access to all BLOCK_COUNT blocks in the native y, z, x order. Loading
+    // marks every section dirty but leaves neighbour chunks alone. It also
+    // relights the chunk with `p_blocks`, so it can run on a worker thread
+    // while the chunk is not yet linked.
+    void load_block_data(const int32_t *p_ids, const GDC_BlockTable &p_blocks);
+    void store_block_data(int32_t *r_ids) const;
+
+    const GDC_ChunkData &get_data() const { return data; }
+
+    // Single block edits update the light incrementally, bulk edits relight the
+    // surrounding chunks. stitch_light() spreads light across the borders of a
+    // newly linked chunk.
+    int32_t get_sky_light(int32_t x, int32_t y, int32_t z) const;
+    int32_t get_block_light(int32_t x, int32_t y, int32_t z) const;
+    void stitch_light();
+    // Marks the sections whose light changed, here or from a neighbour, dirty.
+    // Returns true if there were any.
+    bool take_light_changes();
+    // The registry's block table, or an empty one (every block opaque and solid)
+    // without a registry. Work off the main thread takes a copy.
+    static const GDC_BlockTable &get_block_table();
+
+    // The chunk's blocks in GDC_ChunkCodec's snapshot form. deserialize()
+    // replaces every block like set_box() and returns false, changing nothing,
+    // for a malformed snapshot.
+    PackedByteArray serialize() const;
+    bool deserialize(const PackedByteArray &p_snapshot);
+
+    // While edit tracking is on, the chunk remembers which blocks set_block(),
+    // fill(), fill_range() and set_box() changed. take_delta() encodes their
+    // current ids, so repeated edits of one block coalesce, and forgets them;
+    // apply_delta() replays such a delta on a copy of the chunk, typically in
+    // another world, without tracking the blocks it changes. A delta is a DELTA_* byte followed by a GDC_ChunkCodec
+    // delta, or by a snapshot when that is smaller. Loading block data is not
+    // an edit.
+    static const uint8_t DELTA_BLOCKS = 0;
+    static const uint8_t DELTA_SNAPSHOT = 1;
+    bool is_edit_tracking_enabled() const;
+    void set_edit_tracking_enabled(bool p_enabled);
+    bool has_edits() const;
+    void take_delta(std::vector<uint8_t> &r_delta);
+    PackedByteArray take_delta();
+    bool apply_delta(const uint8_t *p_delta, size_t size);
+    bool apply_delta(const PackedByteArray &p_delta);
+
+    // Set by any block change, cleared by the world once the blocks are saved.
+    bool is_modified() const;
+    void set_modified(bool p_modified);
+
+    int64_t get_block_storage_bytes() const;
+    int32_t get_palette_size() const;
+    void compact_block_storage();
 	
     GDC_Chunk *get_neighbour(int32_t index) const;
     void set_neighbour(int32_t index, GDC_Chunk *neighbour);
 
+    MeshingMode get_meshing_mode() const;
+    void set_meshing_mode(MeshingMode p_mode);
+
+    // Compact vertices only fit block ids up to COMPACT_MAX_BLOCK_ID; while the
+    // registry has more blocks, sections are meshed in the standard format.
+    VertexFormat get_vertex_format() const;
+    void set_vertex_format(VertexFormat p_format);
+
+    // Changing the LOD marks every section dirty. Chunks above LOD 0 have no
+    // collision, and their neighbours must be remeshed too so the seam between
+    // them gets its skirts.
+    int32_t get_lod() const;
+    void set_lod(int32_t p_lod);
+
+    // The world places the chunk: set_world() moves its instances and bodies
+    // into a scenario and physics space (invalid RIDs take them out), and
+    // set_transform() positions the chunk's origin in global space.
+    void set_world(const RID &p_scenario, const RID &p_space);
+    const Transform3D &get_transform() const { return transform; }
+    void set_transform(const Transform3D &p_transform);
+    bool is_visible() const { return visible; }
+    void set_visible(bool p_visible);
+
+    // Returns an unregistered chunk to the state of a new one: all air, open
+    // sky, default settings, nothing meshed. Its section meshes, instances,
+    // bodies and shapes are emptied but kept, so the world can recycle the
+    // chunk without the servers reallocating them.
+    void reset();
+
+    // Mesh and collision work is timed into these stats when set; the world
+    // passes its own to every chunk it registers.
+    GDC_PerfStats *get_perf_stats() const { return p_perf_stats; }
+    void set_perf_stats(GDC_PerfStats *p_stats) { p_perf_stats = p_stats; }
+
+    // CPU-side size of the section meshes currently applied.
+    int64_t get_mesh_bytes() const;
+
 	void generate_mesh();
+    void update_mesh();
+
+    int32_t get_section_non_air_count(int32_t section) const;
+    bool is_section_dirty(int32_t section) const;
+    bool has_dirty_sections() const;
+    void mark_section_dirty(int32_t section);
+    void mark_all_sections_dirty();
+    void clear_section_dirty(int32_t section);
+
+    // Collision is a static body per section made of boxes merged straight from
+    // the blocks. It only has shapes while enabled; update_collision() rebuilds
+    // the sections edited since the last call. Disabling keeps the bodies and
+    // shapes allocated for the next rebuild.
+    bool is_collision_enabled() const;
+    void set_collision_enabled(bool p_enabled);
+    void update_collision();
+    int32_t get_collision_shape_count() const;
+
+    // Face connectivity recorded when the section was last meshed; unmeshed
+    // sections count as fully connected. A culled section's mesh is hidden.
+    int32_t get_section_face_links(int32_t section, int32_t face) const;
+    bool is_section_culled(int32_t section) const;
+    void set_section_culled(int32_t section, bool p_culled);
+
+    // True when the section cannot produce any geometry: it is all air, or it is
+    // completely opaque and every adjacent section is completely opaque too.
+    bool is_section_skippable(int32_t section) const;
+
+    // Split form of update_mesh() for off-thread meshing: capture on the main
+    // thread, build the buffers anywhere, apply back on the main thread.
+    void capture_section_snapshot(int32_t section, GDC_ChunkSnapshot &r_snapshot) const;
+    void apply_section_mesh(int32_t section, const GDC_MeshBuffers &p_buffers);
 
 private:
-	int32_t get_block_including_neighbours(int32_t x, int32_t y, int32_t z) const;
-    void free_static_bodies();
-    void add_collision_shape(ArrayMesh *p_arr_mesh);
+    const GDC_Chunk *get_seam_neighbour(int32_t index) const;
+    void create_section_instance(int32_t section_index);
+    void free_section_instance(Section &r_section);
+    Transform3D get_section_transform(int32_t section_index) const;
+    void mark_block_dirty(int32_t x, int32_t y, int32_t z);
+    void mark_range_dirty(Vector3i from, Vector3i to, uint32_t changed_sections);
+    void mark_border_dirty(bool p_nx, bool p_px, bool p_nz, bool p_pz, uint32_t p_sections);
+    void track_edit(int32_t index);
+    bool replay_delta(const uint8_t *p_delta, size_t size);
+    void clear_edits();
+    void update_section_collision(int32_t section_index);
+    void clear_section_collision(Section &r_section);
+    void free_section_collision(Section &r_section);
 };
 
 } // namespace godot
+
+VARIANT_ENUM_CAST(GDC_Chunk::MeshingMode);
+VARIANT_ENUM_CAST(GDC_Chunk::VertexFormat);
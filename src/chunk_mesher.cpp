@@ -0,0 +1,176 @@
+#include "chunk_mesher.h"
+
+using namespace godot;
+
+static constexpr int32_t FACE_COUNT = GDC_VoxelMesher::FACE_COUNT;
+
+using FaceVertices = std::array<Vector3, 4>;
+
+const std::array<FaceVertices, FACE_COUNT> FACES = {{
+    // Front
+    { Vector3(0, 0, 1), Vector3(0, 1, 1), Vector3(1, 1, 1), Vector3(1, 0, 1) },
+    // Back
+    { Vector3(1, 0, 0), Vector3(1, 1, 0), Vector3(0, 1, 0), Vector3(0, 0, 0) },
+    // Left
+    { Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1), Vector3(0, 0, 1) },
+    // Right
+    { Vector3(1, 0, 1), Vector3(1, 1, 1), Vector3(1, 1, 0), Vector3(1, 0, 0) },
+    // Top
+    { Vector3(0, 1, 1), Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(1, 1, 1) },
+    // Bottom
+    { Vector3(0, 0, 0), Vector3(0, 0, 1), Vector3(1, 0, 1), Vector3(1, 0, 0) }
+}};
+
+const std::array<Vector3, FACE_COUNT> FACE_NORMALS = {
+    Vector3(0, 0, 1), Vector3(0, 0, -1), Vector3(-1, 0, 0),  Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0),
+};
+
+constexpr std::array<float, FACE_COUNT> FACE_BRIGHTNESS = { 
+    1.0f, 0.6f, 0.85f, 0.75f, 0.9f, 0.8f 
+};
+
+// Brightness per light level, 0.8^(15 - level); kept in sync with the voxel
+// shader's LIGHT_BRIGHTNESS.
+constexpr std::array<float, GDC_ChunkData::MAX_LIGHT + 1> LIGHT_BRIGHTNESS = {
+    0.035f, 0.044f, 0.055f, 0.069f, 0.086f, 0.107f, 0.134f, 0.168f,
+    0.210f, 0.262f, 0.328f, 0.410f, 0.512f, 0.640f, 0.800f, 1.0f
+};
+
+// Brightness per AO level, from a corner tucked between two blocks to an open
+// one; kept in sync with the voxel shader's AO_BRIGHTNESS.
+constexpr std::array<float, GDC_VoxelMesher::MAX_AO + 1> AO_BRIGHTNESS = { 0.5f, 0.7f, 0.85f, 1.0f };
+
+const std::array<Vector2, 4> FACE_UVS = {
+    Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1)  
+};
+
+static Color shade_color(const GDC_ChunkSnapshot &p_snapshot, int32_t id, size_t face, int32_t light) {
+    const std::vector<Color> &color_table = p_snapshot.color_table;
+    const Color block_color = (id < static_cast<int32_t>(color_table.size()))
+        ? color_table[id]
+        : Color(1.0f, 0.0f, 0.0f, 1.0f);
+    const float brightness = FACE_BRIGHTNESS[face] * LIGHT_BRIGHTNESS[light];
+    const float alpha = p_snapshot.blocks.is_opaque(id) ? 1.0f : 0.0f;
+    return Color(block_color.r * brightness, block_color.g * brightness, block_color.b * brightness, alpha);
+}
+
+// Raw views into a GDC_MeshBuffers sized for the whole mesh; quads are written
+// straight into their slots instead of appended a vertex at a time.
+struct QuadWriter {
+    Vector3 *p_vertices = nullptr;
+    Vector3 *p_normals = nullptr;
+    Color *p_colors = nullptr;
+    Vector2 *p_uvs = nullptr;
+    Vector2 *p_uv2s = nullptr;
+    Vector2 *p_packed = nullptr;
+    int32_t *p_indices = nullptr;
+};
+
+// Both splits keep the winding of the face tables.
+static void write_quad_indices(int32_t *r_indices, int32_t base, bool flipped) {
+    const std::array<int32_t, 6> corners = flipped ? std::array<int32_t, 6>{ 1, 2, 3, 1, 3, 0 } : std::array<int32_t, 6>{ 0, 1, 2, 0, 2, 3 };
+    for (int32_t i = 0; i < 6; ++i) {
+        r_indices[i] = base + corners[i];
+    }
+}
+
+// UVs are scaled by the quad extent so textures tile once per block; each
+// corner's colour is darkened by its AO level.
+static void write_quad(const QuadWriter &p_writer, int32_t quad_index, const GDC_MeshQuad &p_quad, const Color &color, int32_t layer) {
+    const FaceVertices &face_vertices = FACES[p_quad.face];
+    const Vector3 origin(p_quad.origin[0], p_quad.origin[1], p_quad.origin[2]);
+    const Vector3 size(p_quad.size[0], p_quad.size[1], p_quad.size[2]);
+    const Vector2 uv_scale(
+        (face_vertices[1] - face_vertices[0]).abs().dot(size),
+        (face_vertices[2] - face_vertices[1]).abs().dot(size)
+    );
+
+    const int32_t base = quad_index * 4;
+    for (int j = 0; j < 4; ++j) {
+        p_writer.p_vertices[base + j] = origin + face_vertices[j] * size;
+        p_writer.p_normals[base + j] = FACE_NORMALS[p_quad.face];
+        const float brightness = AO_BRIGHTNESS[p_quad.ao[j]];
+        p_writer.p_colors[base + j] = Color(color.r * brightness, color.g * brightness, color.b * brightness, color.a);
+        p_writer.p_uvs[base + j] = FACE_UVS[j] * uv_scale;
+        p_writer.p_uv2s[base + j] = Vector2(layer, 0);
+    }
+    write_quad_indices(p_writer.p_indices + quad_index * 6, base, p_quad.is_flipped());
+}
+
+// Every field is an integer below 2^24, so each float holds it exactly.
+static void write_packed_quad(const QuadWriter &p_writer, int32_t quad_index, const GDC_MeshQuad &p_quad) {
+    const FaceVertices &face_vertices = FACES[p_quad.face];
+    const Vector3 origin(p_quad.origin[0], p_quad.origin[1], p_quad.origin[2]);
+    const Vector3 size(p_quad.size[0], p_quad.size[1], p_quad.size[2]);
+    const int32_t width = static_cast<int32_t>((face_vertices[1] - face_vertices[0]).abs().dot(size));
+    const int32_t height = static_cast<int32_t>((face_vertices[2] - face_vertices[1]).abs().dot(size));
+    const int32_t block = p_quad.id | (p_quad.light << 12) | ((width - 1) << 16) | ((height - 1) << 20);
+
+    const int32_t base = quad_index * 4;
+    for (int j = 0; j < 4; ++j) {
+        const Vector3 position = origin + face_vertices[j] * size;
+        const int32_t vertex = static_cast<int32_t>(position.x) | (static_cast<int32_t>(position.y) << 5)
+                | (static_cast<int32_t>(position.z) << 10)
+                | (p_quad.face << 15) | (j << 18) | (p_quad.ao[j] << 20);
+        p_writer.p_packed[base + j] = Vector2(vertex, block);
+    }
+    write_quad_indices(p_writer.p_indices + quad_index * 6, base, p_quad.is_flipped());
+}
+
+void GDC_MeshBuffers::resize(int32_t quad_count, bool compact) {
+    const int32_t vertex_count = quad_count * 4;
+    vertices.resize(compact ? 0 : vertex_count);
+    indices.resize(quad_count * 6);
+    normals.resize(compact ? 0 : vertex_count);
+    colors.resize(compact ? 0 : vertex_count);
+    uvs.resize(compact ? 0 : vertex_count);
+    uv2s.resize(compact ? 0 : vertex_count);
+    packed.resize(compact ? vertex_count : 0);
+}
+
+int64_t GDC_MeshBuffers::get_memory_usage() const {
+    return vertices.size() * sizeof(Vector3) + normals.size() * sizeof(Vector3) + colors.size() * sizeof(Color)
+            + (uvs.size() + uv2s.size() + packed.size()) * sizeof(Vector2) + indices.size() * sizeof(int32_t);
+}
+
+// The quads are counted before any vertex is written, so every array is sized
+// exactly once and filled in place.
+void GDC_ChunkMesher::build(const GDC_ChunkSnapshot &p_snapshot, GDC_MeshBuffers &r_buffers) {
+    thread_local std::vector<GDC_MeshQuad> quads;
+    quads.clear();
+    if (p_snapshot.meshing_mode == GDC_Chunk::MESHING_GREEDY) {
+        GDC_VoxelMesher::build_greedy(p_snapshot.cells, p_snapshot.blocks, quads);
+    } else {
+        GDC_VoxelMesher::build_naive(p_snapshot.cells, p_snapshot.blocks, quads);
+    }
+
+    const bool compact = p_snapshot.vertex_format == GDC_Chunk::VERTEX_FORMAT_COMPACT;
+    const int32_t quad_count = static_cast<int32_t>(quads.size());
+    r_buffers.resize(quad_count, compact);
+
+    QuadWriter writer;
+    if (quad_count > 0) {
+        writer.p_indices = r_buffers.indices.ptrw();
+        if (compact) {
+            writer.p_packed = r_buffers.packed.ptrw();
+        } else {
+            writer.p_vertices = r_buffers.vertices.ptrw();
+            writer.p_normals = r_buffers.normals.ptrw();
+            writer.p_colors = r_buffers.colors.ptrw();
+            writer.p_uvs = r_buffers.uvs.ptrw();
+            writer.p_uv2s = r_buffers.uv2s.ptrw();
+        }
+    }
+
+    const std::vector<int32_t> &layer_table = p_snapshot.layer_table;
+    for (int32_t i = 0; i < quad_count; ++i) {
+        const GDC_MeshQuad &quad = quads[i];
+        if (compact) {
+            write_packed_quad(writer, i, quad);
+        } else {
+            const int32_t layer = quad.id < static_cast<int32_t>(layer_table.size()) ? layer_table[quad.id] : -1;
+            write_quad(writer, i, quad, shade_color(p_snapshot, quad.id, quad.face, quad.light), layer);
+        }
+    }
+    GDC_VoxelMesher::compute_face_links(p_snapshot.cells, p_snapshot.blocks, r_buffers.face_links);
+}
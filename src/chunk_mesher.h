@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+
+#include "chunk.h"
+#include "core/voxel_mesher.h"
+
+namespace godot {
+
+// Self-contained copy of everything the mesher reads for one chunk section: its
+// cells with their one-cell border, the block table, and the block colour and
+// texture tables. It owns its data, so it can be meshed on a worker thread
+// while the chunk keeps changing.
+struct GDC_ChunkSnapshot {
+    GDC_SectionCells cells;
+    GDC_BlockTable blocks;
+    std::vector<Color> color_table;
+    std::vector<int32_t> layer_table; // texture array layer per id, -1 = untextured
+    GDC_Chunk::MeshingMode meshing_mode = GDC_Chunk::MESHING_GREEDY;
+    GDC_Chunk::VertexFormat vertex_format = GDC_Chunk::VERTEX_FORMAT_STANDARD;
+};
+
+// Standard meshes fill vertices, normals, colors, uvs and uv2s (x = texture
+// layer); the colour has the face shading, light level and corner AO baked in,
+// and its alpha is 0 for see-through blocks. Compact meshes fill only `packed`,
+// one 2D vertex (ARRAY_VERTEX) per vertex whose two floats carry exact 24-bit
+// integers:
+//   x: section-local position (5 bits per axis, bits 0-14), face (bits 15-17),
+//      corner (bits 18-19) and AO (bits 20-21)
+//   y: block id (bits 0-11), light level (bits 12-15), quad width - 1
+//      (bits 16-19) and height - 1 (bits 20-23)
+// from which the voxel shader rebuilds the position, normal, UV and colour.
+struct GDC_MeshBuffers {
+    PackedVector3Array vertices;
+    PackedVector3Array normals;
+    PackedColorArray colors;
+    PackedVector2Array uvs;
+    PackedVector2Array uv2s;
+    PackedVector2Array packed;
+    PackedInt32Array indices;
+
+    // Which section faces can see each other through air: bit j of
+    // face_links[i] is set when face i connects to face j, using the
+    // GDC_Chunk::SECTION_FACE_* order. Defaults to fully connected.
+    GDC_Chunk::FaceLinks face_links = GDC_ChunkData::make_face_links(GDC_ChunkData::ALL_SECTION_FACES);
+
+    // Sizes every array for `quad_count` quads in one allocation each: the
+    // compact format fills `packed` and `indices`, the standard one everything
+    // but `packed`.
+    void resize(int32_t quad_count, bool compact);
+
+    bool is_empty() const { return vertices.is_empty() && packed.is_empty(); }
+    bool is_compact() const { return !packed.is_empty(); }
+    int32_t get_vertex_count() const { return is_compact() ? packed.size() : vertices.size(); }
+    int64_t get_memory_usage() const;
+};
+
+// Turns a snapshot into vertex buffers: GDC_VoxelMesher finds the quads, which
+// are then expanded in the snapshot's vertex format.
+class GDC_ChunkMesher {
+public:
+    static void build(const GDC_ChunkSnapshot &p_snapshot, GDC_MeshBuffers &r_buffers);
+};
+
+} // namespace godot
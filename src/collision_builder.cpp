@@ -0,0 +1,67 @@
+#include "collision_builder.h"
+
+#include <array>
+
+#include "chunk.h"
+
+using namespace godot;
+
+static constexpr int32_t SIZE = GDC_Chunk::SIZE;
+static constexpr int32_t HEIGHT = GDC_Chunk::SECTION_HEIGHT;
+
+static inline int32_t cell_index(int32_t x, int32_t y, int32_t z) {
+    return (y * SIZE * SIZE) + (z * SIZE) + x;
+}
+
+void GDC_CollisionBuilder::build_boxes(const int32_t *p_ids, const GDC_BlockTable &p_blocks, std::vector<GDC_CollisionBox> &r_boxes) {
+    r_boxes.clear();
+
+    // Cells still waiting for a box: solid and not yet covered.
+    std::array<bool, GDC_Chunk::SECTION_VOLUME> open;
+    for (int32_t i = 0; i < GDC_Chunk::SECTION_VOLUME; ++i) {
+        open[i] = p_blocks.is_solid(p_ids[i]);
+    }
+
+    auto is_row_open = [&open](int32_t x, int32_t y, int32_t z, int32_t width) {
+        for (int32_t i = 0; i < width; ++i) {
+            if (!open[cell_index(x + i, y, z)]) { return false; }
+        }
+        return true;
+    };
+
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        for (int32_t z = 0; z < SIZE; ++z) {
+            for (int32_t x = 0; x < SIZE; ++x) {
+                if (!open[cell_index(x, y, z)]) { continue; }
+
+                int32_t width = 1;
+                while (x + width < SIZE && open[cell_index(x + width, y, z)]) {
+                    ++width;
+                }
+
+                int32_t depth = 1;
+                while (z + depth < SIZE && is_row_open(x, y, z + depth, width)) {
+                    ++depth;
+                }
+
+                int32_t height = 1;
+                for (bool grow = true; grow && y + height < HEIGHT;) {
+                    for (int32_t dz = 0; dz < depth && grow; ++dz) {
+                        grow = is_row_open(x, y + height, z + dz, width);
+                    }
+                    if (grow) { ++height; }
+                }
+
+                for (int32_t dy = 0; dy < height; ++dy) {
+                    for (int32_t dz = 0; dz < depth; ++dz) {
+                        for (int32_t dx = 0; dx < width; ++dx) {
+                            open[cell_index(x + dx, y + dy, z + dz)] = false;
+                        }
+                    }
+                }
+
+                r_boxes.push_back({ Vector3i(x, y, z), Vector3i(width, height, depth) });
+            }
+        }
+    }
+}
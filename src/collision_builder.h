@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <godot_cpp/variant/vector3i.hpp>
+
+#include "core/block_table.h"
+
+namespace godot {
+
+// An axis-aligned block-space box, in section-local coordinates.
+struct GDC_CollisionBox {
+    Vector3i position;
+    Vector3i size;
+};
+
+// Turns the solid cells of a chunk section into a small set of boxes, so the
+// physics server deals with a handful of convex shapes instead of the render
+// mesh's triangles.
+class GDC_CollisionBuilder {
+public:
+    // `p_ids` is one section in the chunk's y, z, x order. Every cell `p_blocks`
+    // marks solid ends up in exactly one box. Boxes grow greedily along x, then
+    // z, then y.
+    static void build_boxes(const int32_t *p_ids, const GDC_BlockTable &p_blocks, std::vector<GDC_CollisionBox> &r_boxes);
+};
+
+} // namespace godot
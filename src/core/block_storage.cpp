@@ -0,0 +1,170 @@
+#include "block_storage.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+static const uint32_t MAX_BITS_PER_ENTRY = 16;
+
+GDC_BlockStorage::GDC_BlockStorage(int32_t p_size, int32_t p_fill_id) :
+        size(p_size) {
+    palette.push_back(p_fill_id);
+}
+
+void GDC_BlockStorage::set(int32_t index, int32_t id) {
+    if (bits_per_entry == 0 && palette[0] == id) {
+        return;
+    }
+    const int32_t palette_index = find_or_add_palette_entry(id);
+    set_palette_index(index, static_cast<uint32_t>(palette_index));
+}
+
+void GDC_BlockStorage::fill(int32_t id) {
+    palette.assign(1, id);
+    data.clear();
+    data.shrink_to_fit();
+    bits_per_entry = 0;
+    entries_per_word_shift = 0;
+    entries_per_word_mask = 0;
+    entry_mask = 0;
+}
+
+void GDC_BlockStorage::assign(const int32_t *p_ids) {
+    std::vector<int32_t> new_palette;
+    std::vector<uint32_t> indices(size);
+    int32_t last_id = p_ids[0];
+    uint32_t last_index = 0;
+    new_palette.push_back(last_id);
+
+    for (int32_t i = 0; i < size; ++i) {
+        const int32_t id = p_ids[i];
+        if (id != last_id) {
+            const auto it = std::find(new_palette.begin(), new_palette.end(), id);
+            last_index = static_cast<uint32_t>(it - new_palette.begin());
+            if (it == new_palette.end()) {
+                new_palette.push_back(id);
+            }
+            last_id = id;
+        }
+        indices[i] = last_index;
+    }
+
+    if (new_palette.size() == 1) {
+        fill(new_palette[0]);
+        return;
+    }
+
+    palette = std::move(new_palette);
+    uint32_t bits = 1;
+    while ((size_t(1) << bits) < palette.size()) {
+        bits *= 2;
+    }
+    repack(bits);
+    for (int32_t i = 0; i < size; ++i) {
+        set_palette_index(i, indices[i]);
+    }
+}
+
+void GDC_BlockStorage::get_range(int32_t start, int32_t count, int32_t *r_out) const {
+    if (bits_per_entry == 0) {
+        std::fill_n(r_out, count, palette[0]);
+        return;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        r_out[i] = palette[get_palette_index(start + i)];
+    }
+}
+
+void GDC_BlockStorage::compact() {
+    if (bits_per_entry == 0) {
+        return;
+    }
+
+    std::vector<uint32_t> remap(palette.size(), UINT32_MAX);
+    std::vector<int32_t> used_palette;
+    for (int32_t i = 0; i < size; ++i) {
+        const uint32_t old_index = get_palette_index(i);
+        if (remap[old_index] == UINT32_MAX) {
+            remap[old_index] = static_cast<uint32_t>(used_palette.size());
+            used_palette.push_back(palette[old_index]);
+        }
+    }
+
+    if (used_palette.size() == palette.size()) {
+        return;
+    }
+    if (used_palette.size() == 1) {
+        fill(used_palette[0]);
+        return;
+    }
+
+    std::vector<uint32_t> indices(size);
+    for (int32_t i = 0; i < size; ++i) {
+        indices[i] = remap[get_palette_index(i)];
+    }
+
+    palette = std::move(used_palette);
+    uint32_t bits = 1;
+    while ((size_t(1) << bits) < palette.size()) {
+        bits *= 2;
+    }
+    repack(bits);
+    for (int32_t i = 0; i < size; ++i) {
+        set_palette_index(i, indices[i]);
+    }
+}
+
+size_t GDC_BlockStorage::get_memory_usage() const {
+    return sizeof(*this) + palette.capacity() * sizeof(int32_t) + data.capacity() * sizeof(uint64_t);
+}
+
+int32_t GDC_BlockStorage::find_or_add_palette_entry(int32_t id) {
+    // Palettes are a handful of entries in practice, so a scan beats hashing.
+    const int32_t palette_size = static_cast<int32_t>(palette.size());
+    for (int32_t i = 0; i < palette_size; ++i) {
+        if (palette[i] == id) {
+            return i;
+        }
+    }
+
+    if (palette.size() >= (size_t(1) << bits_per_entry)) {
+        // Reclaim dead entries before paying for a wider index.
+        compact();
+        if (palette.size() >= (size_t(1) << bits_per_entry)) {
+            const uint32_t bits = bits_per_entry == 0 ? 1 : bits_per_entry * 2;
+            // A compacted palette never has more entries than cells, so 16 bits
+            // is enough for any chunk-sized storage.
+            if (bits > MAX_BITS_PER_ENTRY) {
+                return 0;
+            }
+            std::vector<uint32_t> indices(size, 0);
+            if (bits_per_entry != 0) {
+                for (int32_t i = 0; i < size; ++i) {
+                    indices[i] = get_palette_index(i);
+                }
+            }
+            repack(bits);
+            for (int32_t i = 0; i < size; ++i) {
+                set_palette_index(i, indices[i]);
+            }
+        }
+    }
+
+    palette.push_back(id);
+    return static_cast<int32_t>(palette.size()) - 1;
+}
+
+// Resets the index array to `p_bits` wide entries, all zero.
+void GDC_BlockStorage::repack(uint32_t p_bits) {
+    uint32_t entries_per_word = 64 / p_bits;
+    bits_per_entry = p_bits;
+    entries_per_word_shift = 0;
+    while ((1u << entries_per_word_shift) < entries_per_word) {
+        ++entries_per_word_shift;
+    }
+    entries_per_word_mask = entries_per_word - 1;
+    entry_mask = (uint64_t(1) << p_bits) - 1;
+
+    data.assign((static_cast<size_t>(size) + entries_per_word - 1) / entries_per_word, 0);
+    data.shrink_to_fit();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Palette-compressed block array. Each cell stores an index into a small palette
+// of block ids, bit-packed into 64-bit words (entries never straddle a word, so
+// get/set are a shift and a mask). A storage holding a single id keeps no index
+// array at all. The index width grows 1 -> 2 -> 4 -> 8 -> 16 bits as the palette
+// fills, after first trying to reclaim palette entries that are no longer used.
+class GDC_BlockStorage {
+public:
+    explicit GDC_BlockStorage(int32_t p_size, int32_t p_fill_id = 0);
+
+    inline int32_t get(int32_t index) const {
+        if (bits_per_entry == 0) {
+            return palette[0];
+        }
+        const uint64_t word = data[static_cast<uint32_t>(index) >> entries_per_word_shift];
+        const uint32_t shift = (static_cast<uint32_t>(index) & entries_per_word_mask) * bits_per_entry;
+        return palette[(word >> shift) & entry_mask];
+    }
+
+    void set(int32_t index, int32_t id);
+    void fill(int32_t id);
+
+    // Replaces every cell with `p_ids` (one id per cell), building the palette
+    // and index width in one pass instead of growing it cell by cell.
+    void assign(const int32_t *p_ids);
+
+    // Decodes `count` consecutive cells starting at `start` into `r_out`.
+    void get_range(int32_t start, int32_t count, int32_t *r_out) const;
+
+    // Drops unused palette entries, collapsing back to a single id if possible.
+    void compact();
+
+    bool is_uniform() const { return bits_per_entry == 0; }
+    int32_t get_palette_size() const { return static_cast<int32_t>(palette.size()); }
+    // Every id in use, possibly with some that no longer are until compact().
+    const std::vector<int32_t> &get_palette() const { return palette; }
+    int32_t get_bits_per_entry() const { return static_cast<int32_t>(bits_per_entry); }
+    size_t get_memory_usage() const;
+
+private:
+    int32_t find_or_add_palette_entry(int32_t id);
+    void repack(uint32_t p_bits);
+
+    inline uint32_t get_palette_index(int32_t index) const {
+        const uint64_t word = data[static_cast<uint32_t>(index) >> entries_per_word_shift];
+        const uint32_t shift = (static_cast<uint32_t>(index) & entries_per_word_mask) * bits_per_entry;
+        return static_cast<uint32_t>((word >> shift) & entry_mask);
+    }
+
+    inline void set_palette_index(int32_t index, uint32_t palette_index) {
+        uint64_t &word = data[static_cast<uint32_t>(index) >> entries_per_word_shift];
+        const uint32_t shift = (static_cast<uint32_t>(index) & entries_per_word_mask) * bits_per_entry;
+        word = (word & ~(entry_mask << shift)) | (static_cast<uint64_t>(palette_index) << shift);
+    }
+
+    int32_t size;
+    std::vector<int32_t> palette;
+    std::vector<uint64_t> data;
+
+    uint32_t bits_per_entry = 0; // 0 = uniform, no index array
+    uint32_t entries_per_word_shift = 0;
+    uint32_t entries_per_word_mask = 0;
+    uint64_t entry_mask = 0;
+};
+
+} // namespace godot
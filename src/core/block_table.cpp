@@ -0,0 +1,44 @@
+#include "block_table.h"
+
+using namespace godot;
+
+void GDC_BlockTable::reset(int32_t p_count) {
+    render_layers.assign(p_count, RENDER_LAYER_OPAQUE);
+    opaque.assign(p_count, 1);
+    solid.assign(p_count, 1);
+    emission.assign(p_count, 0);
+    random_ticks.assign(p_count, 0);
+    if (p_count > 0) {
+        opaque[0] = 0;
+        solid[0] = 0;
+    }
+    count = p_count;
+    build_face_culling();
+}
+
+void GDC_BlockTable::set_block(int32_t id, RenderLayer p_layer, bool p_solid, uint8_t p_emission) {
+    if (id <= 0 || id >= get_count()) { return; }
+    render_layers[id] = p_layer;
+    opaque[id] = p_layer == RENDER_LAYER_OPAQUE ? 1 : 0;
+    solid[id] = p_solid ? 1 : 0;
+    emission[id] = p_emission;
+}
+
+void GDC_BlockTable::set_random_ticks(int32_t id, bool p_random_ticks) {
+    if (id <= 0 || id >= get_count()) { return; }
+    random_ticks[id] = p_random_ticks ? 1 : 0;
+}
+
+void GDC_BlockTable::build_face_culling() {
+    row_words = (count + 63) / 64;
+    face_culling.assign(static_cast<size_t>(count) * row_words, 0);
+    for (int32_t id = 1; id < count; ++id) {
+        uint64_t *row = &face_culling[static_cast<size_t>(id) * row_words];
+        for (int32_t neighbour_id = 1; neighbour_id < count; ++neighbour_id) {
+            const bool same_glass = neighbour_id == id && render_layers[id] == RENDER_LAYER_TRANSPARENT;
+            if (opaque[neighbour_id] || same_glass) {
+                row[neighbour_id >> 6] |= uint64_t(1) << (neighbour_id & 63);
+            }
+        }
+    }
+}
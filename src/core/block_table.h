@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Per-id block properties as flat arrays, compiled by GDC_BlockRegistry on
+// reload so the mesher, light engine, raycaster and collision builder can look
+// blocks up without touching any GDC_BlockData. Id 0 is air. Ids the table does
+// not cover (including every id of an empty table) are opaque, solid cubes that
+// emit nothing, which is how all blocks behaved before the table existed.
+class GDC_BlockTable {
+public:
+    enum RenderLayer : uint8_t {
+        RENDER_LAYER_OPAQUE,      // hides the faces behind it and stops light
+        RENDER_LAYER_TRANSPARENT, // see-through; faces between two blocks of the same id are culled (glass)
+        RENDER_LAYER_CUTOUT,      // see-through; every face is drawn (leaves)
+    };
+
+    // Resets to `p_count` ids, air included, all of them opaque, solid and dark
+    // except air, and none of them randomly ticked.
+    void reset(int32_t p_count);
+    // Takes effect on face culling at the next build_face_culling(); call it
+    // once every block is set.
+    void set_block(int32_t id, RenderLayer p_layer, bool p_solid, uint8_t p_emission);
+    void set_random_ticks(int32_t id, bool p_random_ticks);
+    void build_face_culling();
+
+    int32_t get_count() const { return count; }
+
+    // Unsigned compares send air's negative "outside" ids to the fallbacks.
+    inline bool is_opaque(int32_t id) const {
+        return static_cast<uint32_t>(id) < static_cast<uint32_t>(count) ? opaque[id] != 0 : id > 0;
+    }
+    inline bool is_solid(int32_t id) const {
+        return static_cast<uint32_t>(id) < static_cast<uint32_t>(count) ? solid[id] != 0 : id > 0;
+    }
+    inline uint8_t get_emission(int32_t id) const {
+        return static_cast<uint32_t>(id) < static_cast<uint32_t>(count) ? emission[id] : 0;
+    }
+    // Whether the world's random ticks reach blocks of this id.
+    inline bool has_random_ticks(int32_t id) const {
+        return static_cast<uint32_t>(id) < static_cast<uint32_t>(count) && random_ticks[id] != 0;
+    }
+    inline RenderLayer get_render_layer(int32_t id) const {
+        return static_cast<uint32_t>(id) < static_cast<uint32_t>(count) ? static_cast<RenderLayer>(render_layers[id]) : RENDER_LAYER_OPAQUE;
+    }
+
+    // Whether a face of block `id` is hidden by the block `neighbour_id` in front
+    // of it: any opaque block hides it, and a transparent block hides the faces
+    // of its own kind.
+    inline bool is_face_culled(int32_t id, int32_t neighbour_id) const {
+        if (static_cast<uint32_t>(id) < static_cast<uint32_t>(count) && static_cast<uint32_t>(neighbour_id) < static_cast<uint32_t>(count)) {
+            const uint64_t word = face_culling[static_cast<size_t>(id) * row_words + (neighbour_id >> 6)];
+            return (word >> (neighbour_id & 63)) & 1;
+        }
+        return is_opaque(neighbour_id) || (neighbour_id > 0 && neighbour_id == id);
+    }
+
+private:
+    std::vector<uint8_t> render_layers;
+    std::vector<uint8_t> opaque;
+    std::vector<uint8_t> solid;
+    std::vector<uint8_t> emission;
+    std::vector<uint8_t> random_ticks;
+    // One row of bits per id, bit `neighbour_id` set when is_face_culled().
+    std::vector<uint64_t> face_culling;
+    int32_t row_words = 0;
+    int32_t count = 0;
+};
+
+} // namespace godot
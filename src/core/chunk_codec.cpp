@@ -0,0 +1,152 @@
+#include "chunk_codec.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace godot;
+
+void GDC_ChunkCodec::encode_snapshot(const GDC_ChunkData &p_data, std::vector<uint8_t> &r_out) {
+    thread_local std::vector<int32_t> cells;
+    thread_local std::vector<std::pair<uint32_t, uint32_t>> runs; // palette index, length
+    thread_local std::vector<int32_t> palette;
+    cells.resize(GDC_ChunkData::SECTION_VOLUME);
+
+    r_out.clear();
+    for (int32_t section = 0; section < GDC_ChunkData::SECTION_COUNT; ++section) {
+        if (p_data.get_section_non_air_count(section) == 0) {
+            write_varint(r_out, 0);
+            continue;
+        }
+
+        const GDC_BlockStorage &storage = p_data.get_section_storage(section);
+        if (storage.is_uniform()) {
+            write_varint(r_out, 1);
+            write_varint(r_out, static_cast<uint32_t>(storage.get(0)));
+            continue;
+        }
+
+        // The storage's own palette may still list ids that were overwritten,
+        // so the palette written is rebuilt from the runs.
+        storage.get_range(0, GDC_ChunkData::SECTION_VOLUME, cells.data());
+        runs.clear();
+        palette.clear();
+        int32_t i = 0;
+        while (i < GDC_ChunkData::SECTION_VOLUME) {
+            const int32_t id = cells[i];
+            int32_t run = 1;
+            while (i + run < GDC_ChunkData::SECTION_VOLUME && cells[i + run] == id) {
+                ++run;
+            }
+            const size_t palette_index = std::find(palette.begin(), palette.end(), id) - palette.begin();
+            if (palette_index == palette.size()) {
+                palette.push_back(id);
+            }
+            runs.emplace_back(static_cast<uint32_t>(palette_index), static_cast<uint32_t>(run));
+            i += run;
+        }
+
+        write_varint(r_out, static_cast<uint32_t>(palette.size()));
+        for (int32_t id : palette) {
+            write_varint(r_out, static_cast<uint32_t>(id));
+        }
+        if (palette.size() == 1) { continue; }
+        for (const std::pair<uint32_t, uint32_t> &run : runs) {
+            write_varint(r_out, run.first);
+            write_varint(r_out, run.second);
+        }
+    }
+}
+
+bool GDC_ChunkCodec::decode_snapshot(const uint8_t *p_data, size_t size, int32_t *r_ids) {
+    thread_local std::vector<int32_t> palette;
+
+    size_t pos = 0;
+    for (int32_t section = 0; section < GDC_ChunkData::SECTION_COUNT; ++section) {
+        int32_t *p_section = r_ids + section * GDC_ChunkData::SECTION_VOLUME;
+        uint32_t palette_size = 0;
+        if (!read_varint(p_data, size, pos, palette_size)) { return false; }
+        if (palette_size > GDC_ChunkData::SECTION_VOLUME) { return false; }
+        if (palette_size == 0) {
+            std::fill_n(p_section, GDC_ChunkData::SECTION_VOLUME, 0);
+            continue;
+        }
+
+        palette.resize(palette_size);
+        for (int32_t &id : palette) {
+            uint32_t value = 0;
+            if (!read_varint(p_data, size, pos, value)) { return false; }
+            id = static_cast<int32_t>(value);
+        }
+        if (palette_size == 1) {
+            std::fill_n(p_section, GDC_ChunkData::SECTION_VOLUME, palette[0]);
+            continue;
+        }
+
+        uint32_t filled = 0;
+        while (filled < GDC_ChunkData::SECTION_VOLUME) {
+            uint32_t palette_index = 0;
+            uint32_t run = 0;
+            if (!read_varint(p_data, size, pos, palette_index) || !read_varint(p_data, size, pos, run)) { return false; }
+            if (palette_index >= palette_size || run == 0 || run > GDC_ChunkData::SECTION_VOLUME - filled) { return false; }
+
+            std::fill_n(p_section + filled, run, palette[palette_index]);
+            filled += run;
+        }
+    }
+    return pos == size;
+}
+
+void GDC_ChunkCodec::encode_delta(const GDC_ChunkData &p_data, const int32_t *p_indices, int32_t count, std::vector<uint8_t> &r_out) {
+    r_out.clear();
+    write_varint(r_out, static_cast<uint32_t>(count));
+    int32_t previous = 0;
+    for (int32_t i = 0; i < count; ++i) {
+        const int32_t index = p_indices[i];
+        const int32_t section = index / GDC_ChunkData::SECTION_VOLUME;
+        write_varint(r_out, static_cast<uint32_t>(index - previous));
+        write_varint(r_out, static_cast<uint32_t>(p_data.get_section_storage(section).get(index % GDC_ChunkData::SECTION_VOLUME)));
+        previous = index;
+    }
+}
+
+bool GDC_ChunkCodec::decode_delta(const uint8_t *p_data, size_t size, std::vector<int32_t> &r_indices, std::vector<int32_t> &r_ids) {
+    r_indices.clear();
+    r_ids.clear();
+
+    size_t pos = 0;
+    uint32_t count = 0;
+    if (!read_varint(p_data, size, pos, count)) { return false; }
+    if (count > GDC_ChunkData::BLOCK_COUNT) { return false; }
+
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t gap = 0;
+        uint32_t id = 0;
+        if (!read_varint(p_data, size, pos, gap) || !read_varint(p_data, size, pos, id)) { return false; }
+        if (gap >= GDC_ChunkData::BLOCK_COUNT - index) { return false; }
+
+        index += gap;
+        r_indices.push_back(static_cast<int32_t>(index));
+        r_ids.push_back(static_cast<int32_t>(id));
+    }
+    return pos == size;
+}
+
+void GDC_ChunkCodec::write_varint(std::vector<uint8_t> &r_out, uint32_t value) {
+    while (value >= 0x80) {
+        r_out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    r_out.push_back(static_cast<uint8_t>(value));
+}
+
+bool GDC_ChunkCodec::read_varint(const uint8_t *p_data, size_t size, size_t &r_pos, uint32_t &r_value) {
+    r_value = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        if (r_pos >= size) { return false; }
+        const uint8_t byte = p_data[r_pos++];
+        r_value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) { return true; }
+    }
+    return false;
+}
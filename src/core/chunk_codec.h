@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "chunk_data.h"
+
+namespace godot {
+
+// Compact byte encodings of chunk blocks, for mirroring one world into another.
+//
+// A snapshot holds a whole chunk, section by section: a varint palette length
+// (0 for an all-air section), the varint palette ids, and then, unless the
+// palette has a single id, (varint palette index, varint run length) runs over
+// the section in y, z, x order.
+//
+// A delta holds some blocks of a chunk: a varint block count, then per block
+// the varint gap to the previous block's index (indices ascending, the first
+// gap counted from 0) and its varint id. Edits to one block in a row of ticks
+// coalesce into its latest id before they are encoded.
+class GDC_ChunkCodec {
+public:
+    static void encode_snapshot(const GDC_ChunkData &p_data, std::vector<uint8_t> &r_out);
+    // Fills BLOCK_COUNT ids in the native y, z, x order; false on malformed input.
+    static bool decode_snapshot(const uint8_t *p_data, size_t size, int32_t *r_ids);
+
+    // `p_indices` must be ascending and unique; the ids are read from `p_data`.
+    static void encode_delta(const GDC_ChunkData &p_data, const int32_t *p_indices, int32_t count, std::vector<uint8_t> &r_out);
+    static bool decode_delta(const uint8_t *p_data, size_t size, std::vector<int32_t> &r_indices, std::vector<int32_t> &r_ids);
+
+    // LEB128: 7 bits per byte, low bits first.
+    static void write_varint(std::vector<uint8_t> &r_out, uint32_t value);
+    static bool read_varint(const uint8_t *p_data, size_t size, size_t &r_pos, uint32_t &r_value);
+};
+
+} // namespace godot
@@ -0,0 +1,424 @@
+#include "chunk_data.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace godot;
+
+GDC_ChunkData::GDC_ChunkData() :
+        light(BLOCK_COUNT, OPEN_SKY_LIGHT) {
+    neighbours.fill(nullptr);
+}
+
+int32_t GDC_ChunkData::get_block(const int32_t x, const int32_t y, const int32_t z) const {
+    if (x >= 0 && y >= 0 && z >= 0 && x < SIZE && y < HEIGHT && z < SIZE) {
+        const Section &section = sections[y / SECTION_HEIGHT];
+        return section.blocks.get(((y % SECTION_HEIGHT) * SIZE * SIZE) + (z * SIZE) + x);
+    }
+    return -1;
+}
+
+bool GDC_ChunkData::set_block(const int32_t x, const int32_t y, const int32_t z, int32_t id) {
+    if (x < 0 || y < 0 || z < 0 || x >= SIZE || y >= HEIGHT || z >= SIZE) {
+        return false;
+    }
+
+    Section &section = sections[y / SECTION_HEIGHT];
+    const int32_t index = ((y % SECTION_HEIGHT) * SIZE * SIZE) + (z * SIZE) + x;
+    const int32_t old_id = section.blocks.get(index);
+    if (old_id == id) {
+        return false;
+    }
+
+    section.blocks.set(index, id);
+    section.non_air_count += (id > 0 ? 1 : 0) - (old_id > 0 ? 1 : 0);
+    return true;
+}
+
+void GDC_ChunkData::fill(int32_t id) {
+    for (Section &section : sections) {
+        section.blocks.fill(id);
+        section.non_air_count = id > 0 ? SECTION_VOLUME : 0;
+    }
+}
+
+uint32_t GDC_ChunkData::fill_range(int32_t from_x, int32_t from_y, int32_t from_z, int32_t to_x, int32_t to_y, int32_t to_z, int32_t id,
+        std::vector<int32_t> *r_changed) {
+    const int32_t start_x = std::clamp(from_x, 0, SIZE);
+    const int32_t start_y = std::clamp(from_y, 0, HEIGHT);
+    const int32_t start_z = std::clamp(from_z, 0, SIZE);
+
+    const int32_t end_x = std::clamp(to_x, 0, SIZE);
+    const int32_t end_y = std::clamp(to_y, 0, HEIGHT);
+    const int32_t end_z = std::clamp(to_z, 0, SIZE);
+
+    if (start_x >= end_x || start_y >= end_y || start_z >= end_z) {
+        return 0;
+    }
+
+    const bool full_columns = start_x == 0 && start_z == 0 && end_x == SIZE && end_z == SIZE;
+    uint32_t changed = 0;
+
+    for (int32_t y = start_y; y < end_y;) {
+        const int32_t section_index = y / SECTION_HEIGHT;
+        const int32_t section_end = std::min(end_y, (section_index + 1) * SECTION_HEIGHT);
+
+        if (full_columns && y % SECTION_HEIGHT == 0 && section_end - y == SECTION_HEIGHT) {
+            Section &section = sections[section_index];
+            if (r_changed != nullptr && !(section.blocks.is_uniform() && section.blocks.get(0) == id)) {
+                thread_local std::vector<int32_t> cells(SECTION_VOLUME);
+                section.blocks.get_range(0, SECTION_VOLUME, cells.data());
+                for (int32_t i = 0; i < SECTION_VOLUME; ++i) {
+                    if (cells[i] != id) {
+                        r_changed->push_back(section_index * SECTION_VOLUME + i);
+                    }
+                }
+            }
+            section.blocks.fill(id);
+            section.non_air_count = id > 0 ? SECTION_VOLUME : 0;
+            changed |= 1u << section_index;
+            y = section_end;
+            continue;
+        }
+
+        for (; y < section_end; ++y) {
+            for (int32_t z = start_z; z < end_z; ++z) {
+                for (int32_t x = start_x; x < end_x; ++x) {
+                    if (set_block(x, y, z, id)) {
+                        changed |= 1u << section_index;
+                        if (r_changed != nullptr) {
+                            r_changed->push_back((y * SIZE + z) * SIZE + x);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+bool GDC_ChunkData::is_section_opaque(int32_t section, const GDC_BlockTable &p_blocks) const {
+    if (!is_section_full(section)) { return false; }
+    const std::vector<int32_t> &palette = sections[section].blocks.get_palette();
+    return std::all_of(palette.begin(), palette.end(), [&p_blocks](int32_t id) { return p_blocks.is_opaque(id); });
+}
+
+bool GDC_ChunkData::has_random_ticks(int32_t section, const GDC_BlockTable &p_blocks) const {
+    if (sections[section].non_air_count == 0) { return false; }
+    const std::vector<int32_t> &palette = sections[section].blocks.get_palette();
+    return std::any_of(palette.begin(), palette.end(), [&p_blocks](int32_t id) { return p_blocks.has_random_ticks(id); });
+}
+
+void GDC_ChunkData::get_box(int32_t from_x, int32_t from_y, int32_t from_z, int32_t to_x, int32_t to_y, int32_t to_z,
+        int32_t *r_ids, int32_t row_stride, int32_t layer_stride) const {
+    const int32_t width = to_x - from_x;
+    for (int32_t y = from_y; y < to_y; ++y) {
+        const GDC_BlockStorage &blocks = sections[y / SECTION_HEIGHT].blocks;
+        const int32_t layer = (y % SECTION_HEIGHT) * SIZE * SIZE;
+        int32_t *p_layer = r_ids + (y - from_y) * layer_stride;
+        for (int32_t z = from_z; z < to_z; ++z) {
+            blocks.get_range(layer + (z * SIZE) + from_x, width, p_layer + (z - from_z) * row_stride);
+        }
+    }
+}
+
+// Each touched section is decoded once, patched row by row and re-encoded in a
+// single assign(), instead of growing its palette one set() at a time.
+uint32_t GDC_ChunkData::set_box(int32_t from_x, int32_t from_y, int32_t from_z, int32_t to_x, int32_t to_y, int32_t to_z,
+        const int32_t *p_ids, int32_t row_stride, int32_t layer_stride, std::vector<int32_t> *r_changed) {
+    thread_local std::vector<int32_t> cells(SECTION_VOLUME);
+    const int32_t width = to_x - from_x;
+    uint32_t changed = 0;
+
+    for (int32_t y = from_y; y < to_y;) {
+        const int32_t section_index = y / SECTION_HEIGHT;
+        const int32_t section_end = std::min(to_y, (section_index + 1) * SECTION_HEIGHT);
+        Section &section = sections[section_index];
+        section.blocks.get_range(0, SECTION_VOLUME, cells.data());
+
+        bool section_changed = false;
+        for (; y < section_end; ++y) {
+            const int32_t *p_layer = p_ids + (y - from_y) * layer_stride;
+            for (int32_t z = from_z; z < to_z; ++z) {
+                const int32_t *p_row = p_layer + (z - from_z) * row_stride;
+                int32_t *p_cells = cells.data() + ((y % SECTION_HEIGHT) * SIZE + z) * SIZE + from_x;
+                if (!std::equal(p_row, p_row + width, p_cells)) {
+                    if (r_changed != nullptr) {
+                        for (int32_t x = 0; x < width; ++x) {
+                            if (p_row[x] != p_cells[x]) {
+                                r_changed->push_back((y * SIZE + z) * SIZE + from_x + x);
+                            }
+                        }
+                    }
+                    std::copy_n(p_row, width, p_cells);
+                    section_changed = true;
+                }
+            }
+        }
+        if (!section_changed) { continue; }
+
+        section.blocks.assign(cells.data());
+        section.non_air_count = static_cast<int32_t>(std::count_if(cells.begin(), cells.end(),
+                [](int32_t id) { return id > 0; }));
+        changed |= 1u << section_index;
+    }
+    return changed;
+}
+
+void GDC_ChunkData::load_blocks(const int32_t *p_ids) {
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        const int32_t *p_section_ids = p_ids + (i * SECTION_VOLUME);
+        Section &section = sections[i];
+        section.blocks.assign(p_section_ids);
+        section.non_air_count = static_cast<int32_t>(std::count_if(p_section_ids, p_section_ids + SECTION_VOLUME,
+                [](int32_t id) { return id > 0; }));
+    }
+}
+
+void GDC_ChunkData::store_blocks(int32_t *r_ids) const {
+    for (int32_t i = 0; i < SECTION_COUNT; ++i) {
+        sections[i].blocks.get_range(0, SECTION_VOLUME, r_ids + (i * SECTION_VOLUME));
+    }
+}
+
+uint8_t GDC_ChunkData::get_light(const int32_t x, const int32_t y, const int32_t z) const {
+    if (y >= HEIGHT) { return OPEN_SKY_LIGHT; }
+    if (x < 0 || y < 0 || z < 0 || x >= SIZE || z >= SIZE) { return 0; }
+    return light[((y * SIZE) + z) * SIZE + x];
+}
+
+void GDC_ChunkData::set_light_index(int32_t index, uint8_t p_light) {
+    light[index] = p_light;
+
+    const int32_t x = index % SIZE;
+    const int32_t z = (index / SIZE) % SIZE;
+    const int32_t y = index / (SIZE * SIZE);
+    const int32_t section = y / SECTION_HEIGHT;
+
+    // Faces of the blocks around this one are lit by it.
+    light_dirty_sections |= 1u << section;
+    if (y % SECTION_HEIGHT == 0 && section > 0) {
+        light_dirty_sections |= 1u << (section - 1);
+    }
+    if (y % SECTION_HEIGHT == SECTION_HEIGHT - 1 && section + 1 < SECTION_COUNT) {
+        light_dirty_sections |= 1u << (section + 1);
+    }
+    if (x == 0 && neighbours[NEIGHBOUR_NX] != nullptr) { neighbours[NEIGHBOUR_NX]->light_dirty_sections |= 1u << section; }
+    if (x == SIZE - 1 && neighbours[NEIGHBOUR_PX] != nullptr) { neighbours[NEIGHBOUR_PX]->light_dirty_sections |= 1u << section; }
+    if (z == 0 && neighbours[NEIGHBOUR_NZ] != nullptr) { neighbours[NEIGHBOUR_NZ]->light_dirty_sections |= 1u << section; }
+    if (z == SIZE - 1 && neighbours[NEIGHBOUR_PZ] != nullptr) { neighbours[NEIGHBOUR_PZ]->light_dirty_sections |= 1u << section; }
+}
+
+void GDC_ChunkData::fill_light(uint8_t p_light) {
+    std::fill(light.begin(), light.end(), p_light);
+    light_dirty_sections = (1u << SECTION_COUNT) - 1;
+}
+
+uint32_t GDC_ChunkData::take_light_dirty_sections() {
+    return std::exchange(light_dirty_sections, 0u);
+}
+
+int64_t GDC_ChunkData::get_storage_bytes() const {
+    int64_t total = 0;
+    for (const Section &section : sections) {
+        total += static_cast<int64_t>(section.blocks.get_memory_usage());
+    }
+    return total;
+}
+
+// Total palette entries across all sections.
+int32_t GDC_ChunkData::get_palette_size() const {
+    int32_t total = 0;
+    for (const Section &section : sections) {
+        total += section.blocks.get_palette_size();
+    }
+    return total;
+}
+
+void GDC_ChunkData::compact() {
+    for (Section &section : sections) {
+        section.blocks.compact();
+    }
+}
+
+void GDC_ChunkData::capture_section(int32_t section, int32_t lod, const Neighbours &p_neighbours, const GDC_BlockTable &p_blocks,
+        GDC_SectionCells &r_cells) const {
+    if (lod > 0) {
+        capture_lod_section(section, lod, p_neighbours, p_blocks, r_cells);
+        return;
+    }
+
+    constexpr int32_t PADDED = SIZE + 2;
+    r_cells.size = SIZE;
+    r_cells.height = SECTION_HEIGHT;
+    r_cells.scale = 1;
+    r_cells.blocks.resize(static_cast<size_t>(PADDED) * PADDED * (SECTION_HEIGHT + 2));
+    r_cells.light.resize(r_cells.blocks.size());
+
+    const int32_t base_y = section * SECTION_HEIGHT;
+    for (int32_t ly = -1; ly <= SECTION_HEIGHT; ++ly) {
+        const int32_t y = base_y + ly;
+        const size_t layer_index = static_cast<size_t>(ly + 1) * PADDED * PADDED;
+        int32_t *p_layer = &r_cells.blocks[layer_index];
+        uint8_t *p_light_layer = &r_cells.light[layer_index];
+        if (y < 0 || y >= HEIGHT) {
+            std::fill_n(p_layer, PADDED * PADDED, 0);
+            std::fill_n(p_light_layer, PADDED * PADDED, y < 0 ? 0 : OPEN_SKY_LIGHT);
+            continue;
+        }
+
+        const GDC_BlockStorage &storage = sections[y / SECTION_HEIGHT].blocks;
+        const int32_t layer_offset = (y % SECTION_HEIGHT) * SIZE * SIZE;
+        for (int32_t z = -1; z <= SIZE; ++z) {
+            int32_t *p_row = p_layer + (z + 1) * PADDED;
+            uint8_t *p_light_row = p_light_layer + (z + 1) * PADDED;
+            if (z >= 0 && z < SIZE) {
+                storage.get_range(layer_offset + (z * SIZE), SIZE, p_row + 1);
+                p_row[0] = get_block_from(p_neighbours, -1, y, z);
+                p_row[PADDED - 1] = get_block_from(p_neighbours, SIZE, y, z);
+
+                std::copy_n(&light[(y * SIZE + z) * SIZE], SIZE, p_light_row + 1);
+                p_light_row[0] = get_light_from(p_neighbours, -1, y, z);
+                p_light_row[PADDED - 1] = get_light_from(p_neighbours, SIZE, y, z);
+            } else {
+                for (int32_t x = -1; x <= SIZE; ++x) {
+                    p_row[x + 1] = get_block_from(p_neighbours, x, y, z);
+                    p_light_row[x + 1] = get_light_from(p_neighbours, x, y, z);
+                }
+            }
+        }
+    }
+}
+
+// The chunk holding the border block at chunk-local (r_x, r_z), with the
+// coordinates made local to it; null when that chunk is missing. Diagonal
+// corner columns are reached through a neighbour's own link.
+const GDC_ChunkData *GDC_ChunkData::find_border_chunk(const Neighbours &p_neighbours, int32_t &r_x, int32_t &r_z) const {
+    const int32_t step_x = r_x < 0 ? NEIGHBOUR_NX : (r_x >= SIZE ? NEIGHBOUR_PX : -1);
+    const int32_t step_z = r_z < 0 ? NEIGHBOUR_NZ : (r_z >= SIZE ? NEIGHBOUR_PZ : -1);
+    r_x = (r_x + SIZE) % SIZE;
+    r_z = (r_z + SIZE) % SIZE;
+
+    if (step_x < 0) { return step_z < 0 ? this : p_neighbours[step_z]; }
+    if (step_z < 0) { return p_neighbours[step_x]; }
+    if (p_neighbours[step_x] != nullptr) { return p_neighbours[step_x]->get_neighbour(step_z); }
+    return p_neighbours[step_z] != nullptr ? p_neighbours[step_z]->get_neighbour(step_x) : nullptr;
+}
+
+int32_t GDC_ChunkData::get_block_from(const Neighbours &p_neighbours, int32_t x, const int32_t y, int32_t z) const {
+    if (y < 0 || y >= HEIGHT) { return 0; }
+
+    const GDC_ChunkData *p_chunk = find_border_chunk(p_neighbours, x, z);
+    return p_chunk != nullptr ? p_chunk->get_block(x, y, z) : 0;
+}
+
+// Missing neighbours read as air, so they are lit like open sky.
+uint8_t GDC_ChunkData::get_light_from(const Neighbours &p_neighbours, int32_t x, const int32_t y, int32_t z) const {
+    if (y >= HEIGHT) { return OPEN_SKY_LIGHT; }
+    if (y < 0) { return 0; }
+
+    const GDC_ChunkData *p_chunk = find_border_chunk(p_neighbours, x, z);
+    return p_chunk != nullptr ? p_chunk->get_light(x, y, z) : OPEN_SKY_LIGHT;
+}
+
+// Chunk-local block coordinates of the cell's minimum corner. A block fills the
+// cell when it is opaque or solid, so see-through decoration such as flowers
+// does not. The cell is filled when at least half of its blocks are; it then
+// takes the most common filling block of its highest filled layer, so terrain
+// keeps its surface block (grass rather than the dirt beneath it).
+int32_t GDC_ChunkData::sample_lod_cell(int32_t x, int32_t y, int32_t z, int32_t scale, const GDC_BlockTable &p_blocks) const {
+    auto fills = [&p_blocks](int32_t id) { return p_blocks.is_opaque(id) || p_blocks.is_solid(id); };
+
+    int32_t solid = 0;
+    int32_t top_y = -1;
+    for (int32_t by = y + scale - 1; by >= y; --by) {
+        const GDC_BlockStorage &storage = sections[by / SECTION_HEIGHT].blocks;
+        const int32_t layer_offset = (by % SECTION_HEIGHT) * SIZE * SIZE;
+        for (int32_t bz = z; bz < z + scale; ++bz) {
+            for (int32_t bx = x; bx < x + scale; ++bx) {
+                if (fills(storage.get(layer_offset + (bz * SIZE) + bx))) {
+                    ++solid;
+                    top_y = std::max(top_y, by);
+                }
+            }
+        }
+    }
+    if (solid * 2 < scale * scale * scale) {
+        return 0;
+    }
+
+    // At most (2^MAX_LOD)^2 distinct ids in one layer.
+    std::array<std::pair<int32_t, int32_t>, (1 << MAX_LOD) * (1 << MAX_LOD)> counts;
+    int32_t distinct = 0;
+    int32_t best = 0;
+    const GDC_BlockStorage &storage = sections[top_y / SECTION_HEIGHT].blocks;
+    const int32_t layer_offset = (top_y % SECTION_HEIGHT) * SIZE * SIZE;
+    for (int32_t bz = z; bz < z + scale; ++bz) {
+        for (int32_t bx = x; bx < x + scale; ++bx) {
+            const int32_t id = storage.get(layer_offset + (bz * SIZE) + bx);
+            if (!fills(id)) { continue; }
+
+            int32_t i = 0;
+            while (i < distinct && counts[i].first != id) {
+                ++i;
+            }
+            if (i == distinct) {
+                counts[distinct++] = { id, 0 };
+            }
+            if (++counts[i].second > counts[best].second) {
+                best = i;
+            }
+        }
+    }
+    return counts[best].first;
+}
+
+// The brightest sky and block light within the cell, so a coarse air cell is
+// never darker than the open blocks it stands for.
+uint8_t GDC_ChunkData::sample_lod_light(int32_t x, int32_t y, int32_t z, int32_t scale) const {
+    uint8_t sky = 0;
+    uint8_t block = 0;
+    for (int32_t by = y; by < y + scale; ++by) {
+        for (int32_t bz = z; bz < z + scale; ++bz) {
+            const uint8_t *p_row = &light[(by * SIZE + bz) * SIZE + x];
+            for (int32_t bx = 0; bx < scale; ++bx) {
+                sky = std::max<uint8_t>(sky, p_row[bx] >> 4);
+                block = std::max<uint8_t>(block, p_row[bx] & 0x0f);
+            }
+        }
+    }
+    return static_cast<uint8_t>((sky << 4) | block);
+}
+
+void GDC_ChunkData::capture_lod_section(int32_t section, int32_t lod, const Neighbours &p_neighbours, const GDC_BlockTable &p_blocks,
+        GDC_SectionCells &r_cells) const {
+    const int32_t scale = 1 << lod;
+    const int32_t cells = SIZE / scale;
+    const int32_t cell_height = SECTION_HEIGHT / scale;
+    const int32_t padded = cells + 2;
+    r_cells.size = cells;
+    r_cells.height = cell_height;
+    r_cells.scale = scale;
+    r_cells.blocks.assign(static_cast<size_t>(padded) * padded * (cell_height + 2), 0);
+    r_cells.light.assign(r_cells.blocks.size(), OPEN_SKY_LIGHT);
+
+    for (int32_t cy = -1; cy <= cell_height; ++cy) {
+        const int32_t y = section * SECTION_HEIGHT + cy * scale;
+        if (y < 0 || y >= HEIGHT) { continue; }
+
+        for (int32_t cz = -1; cz <= cells; ++cz) {
+            for (int32_t cx = -1; cx <= cells; ++cx) {
+                // The whole border ring is filled, edges and corners included,
+                // since AO reads the cells diagonally across the section too.
+                int32_t x = cx * scale;
+                int32_t z = cz * scale;
+                const GDC_ChunkData *p_source = find_border_chunk(p_neighbours, x, z);
+                if (p_source == nullptr) { continue; }
+
+                const size_t index = (static_cast<size_t>(cy + 1) * padded + (cz + 1)) * padded + (cx + 1);
+                r_cells.blocks[index] = p_source->sample_lod_cell(x, y, z, scale, p_blocks);
+                r_cells.light[index] = p_source->sample_lod_light(x, y, z, scale);
+            }
+        }
+    }
+}
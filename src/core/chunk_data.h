@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "block_storage.h"
+#include "block_table.h"
+
+namespace godot {
+
+// The cells of one chunk section plus a one-cell border from the sections above
+// and below and from the four neighbouring chunks; the input of the meshers.
+// At LOD > 0 each cell stands for a `scale`-sized cube of blocks, and `size` and
+// `height` count cells rather than blocks.
+struct GDC_SectionCells {
+    std::vector<int32_t> blocks; // x/z in [-1, size], y in [-1, height], stored with a +1 offset
+    std::vector<uint8_t> light;  // same layout, packed as in GDC_ChunkData::get_light()
+    int32_t size = 16;
+    int32_t height = 16;
+    int32_t scale = 1;
+
+    // Section-local cell coordinates, valid for one cell beyond the section bounds.
+    inline int32_t get_block(int32_t x, int32_t y, int32_t z) const {
+        const int32_t padded = size + 2;
+        return blocks[((y + 1) * padded * padded) + ((z + 1) * padded) + (x + 1)];
+    }
+
+    inline uint8_t get_light(int32_t x, int32_t y, int32_t z) const {
+        const int32_t padded = size + 2;
+        return light[((y + 1) * padded * padded) + ((z + 1) * padded) + (x + 1)];
+    }
+};
+
+// The blocks of one chunk column, without any engine state: a palette-compressed
+// storage per 16-block-high section, the count of non-air blocks in each, and
+// links to the four horizontal neighbours. GDC_Chunk wraps it with meshes,
+// collision and dirty tracking; benchmarks and tools use it directly.
+class GDC_ChunkData {
+public:
+    static constexpr int32_t SIZE = 16;
+    static constexpr int32_t HEIGHT = 128;
+    static constexpr int32_t BLOCK_COUNT = SIZE * SIZE * HEIGHT;
+
+    static constexpr int32_t SECTION_HEIGHT = 16;
+    static constexpr int32_t SECTION_COUNT = HEIGHT / SECTION_HEIGHT;
+    static constexpr int32_t SECTION_VOLUME = SIZE * SIZE * SECTION_HEIGHT;
+
+    static constexpr int32_t NEIGHBOUR_PX = 0; // +X neighbour
+    static constexpr int32_t NEIGHBOUR_NX = 1; // -X neighbour
+    static constexpr int32_t NEIGHBOUR_PZ = 2; // +Z neighbour
+    static constexpr int32_t NEIGHBOUR_NZ = 3; // -Z neighbour
+
+    // Faces of a section in the visibility graph. The horizontal ones share the
+    // NEIGHBOUR_* indices; opposite faces differ only in the lowest bit.
+    static constexpr int32_t SECTION_FACE_PY = 4;
+    static constexpr int32_t SECTION_FACE_NY = 5;
+    static constexpr int32_t SECTION_FACE_COUNT = 6;
+    static constexpr uint8_t ALL_SECTION_FACES = (1 << SECTION_FACE_COUNT) - 1;
+
+    // Bit j of entry i is set when face i can see face j through the section.
+    using FaceLinks = std::array<uint8_t, SECTION_FACE_COUNT>;
+    static FaceLinks make_face_links(uint8_t p_mask) {
+        FaceLinks links;
+        links.fill(p_mask);
+        return links;
+    }
+
+    // Level of detail n samples 2^n-sized cubes of blocks as one cell.
+    static constexpr int32_t MAX_LOD = 3;
+
+    using Neighbours = std::array<const GDC_ChunkData *, 4>;
+
+    // Light levels run from 0 to MAX_LIGHT and are stored per block as
+    // (sky << 4) | block. Above the chunk is open sky; below it is dark.
+    static constexpr int32_t MAX_LIGHT = 15;
+    static constexpr uint8_t OPEN_SKY_LIGHT = MAX_LIGHT << 4;
+
+    GDC_ChunkData();
+
+    // -1 outside the chunk.
+    int32_t get_block(int32_t x, int32_t y, int32_t z) const;
+    // Returns false when the block already had that id or is outside the chunk.
+    bool set_block(int32_t x, int32_t y, int32_t z, int32_t id);
+
+    void fill(int32_t id);
+    // Fills [from, to) clipped to the chunk and returns a bit per section whose
+    // blocks were written. Whole sections collapse to a single palette entry.
+    // With `r_changed`, the native index of every block whose id changed is
+    // appended to it.
+    uint32_t fill_range(int32_t from_x, int32_t from_y, int32_t from_z, int32_t to_x, int32_t to_y, int32_t to_z, int32_t id,
+            std::vector<int32_t> *r_changed = nullptr);
+
+    // Copy the blocks in [from, to), which must lie inside the chunk, to or
+    // from ids in y, z, x order starting at the box's first cell, with rows (z)
+    // and layers (y) `row_stride` and `layer_stride` ids apart. set_box()
+    // returns a bit per section whose blocks changed and reports the changed
+    // blocks in `r_changed` like fill_range().
+    void get_box(int32_t from_x, int32_t from_y, int32_t from_z, int32_t to_x, int32_t to_y, int32_t to_z,
+            int32_t *r_ids, int32_t row_stride, int32_t layer_stride) const;
+    uint32_t set_box(int32_t from_x, int32_t from_y, int32_t from_z, int32_t to_x, int32_t to_y, int32_t to_z,
+            const int32_t *p_ids, int32_t row_stride, int32_t layer_stride, std::vector<int32_t> *r_changed = nullptr);
+
+    // All BLOCK_COUNT blocks in the native y, z, x order.
+    void load_blocks(const int32_t *p_ids);
+    void store_blocks(int32_t *r_ids) const;
+
+    const GDC_BlockStorage &get_section_storage(int32_t section) const { return sections[section].blocks; }
+    int32_t get_section_non_air_count(int32_t section) const { return sections[section].non_air_count; }
+    bool is_section_full(int32_t section) const { return sections[section].non_air_count == SECTION_VOLUME; }
+    // Full and made only of opaque blocks, so nothing can be seen through it. Ids
+    // left in the palette after they were overwritten can make this false for a
+    // section that is; that only costs a remesh.
+    bool is_section_opaque(int32_t section, const GDC_BlockTable &p_blocks) const;
+    // Whether the section may hold blocks that take random ticks; the same
+    // leftover palette ids can make this true for one that does not.
+    bool has_random_ticks(int32_t section, const GDC_BlockTable &p_blocks) const;
+
+    int64_t get_storage_bytes() const;
+    int32_t get_palette_size() const;
+    void compact();
+
+    // Filled by GDC_LightEngine; until then every block is open sky.
+    uint8_t get_light(int32_t x, int32_t y, int32_t z) const;
+    uint8_t get_light_index(int32_t index) const { return light[index]; }
+    // `index` is in the native y, z, x order. Flags every section whose mesh
+    // samples the block, including those of neighbouring chunks.
+    void set_light_index(int32_t index, uint8_t p_light);
+    void fill_light(uint8_t p_light);
+    // Returns and clears the bit per section flagged by set_light_index().
+    uint32_t take_light_dirty_sections();
+
+    const GDC_ChunkData *get_neighbour(int32_t index) const { return neighbours[index]; }
+    GDC_ChunkData *get_neighbour(int32_t index) { return neighbours[index]; }
+    void set_neighbour(int32_t index, GDC_ChunkData *p_neighbour) { neighbours[index] = p_neighbour; }
+
+    // Copies the section into `r_cells` at 2^lod blocks per cell. Border cells
+    // come from `p_neighbours` (which may differ from the linked neighbours,
+    // e.g. to leave out chunks meshed at another LOD); missing ones are air.
+    // `p_blocks` decides which blocks fill a cell when lod > 0.
+    void capture_section(int32_t section, int32_t lod, const Neighbours &p_neighbours, const GDC_BlockTable &p_blocks,
+            GDC_SectionCells &r_cells) const;
+
+private:
+    struct Section {
+        GDC_BlockStorage blocks{ SECTION_VOLUME };
+        int32_t non_air_count = 0;
+    };
+
+    const GDC_ChunkData *find_border_chunk(const Neighbours &p_neighbours, int32_t &r_x, int32_t &r_z) const;
+    int32_t get_block_from(const Neighbours &p_neighbours, int32_t x, int32_t y, int32_t z) const;
+    uint8_t get_light_from(const Neighbours &p_neighbours, int32_t x, int32_t y, int32_t z) const;
+    int32_t sample_lod_cell(int32_t x, int32_t y, int32_t z, int32_t scale, const GDC_BlockTable &p_blocks) const;
+    uint8_t sample_lod_light(int32_t x, int32_t y, int32_t z, int32_t scale) const;
+    void capture_lod_section(int32_t section, int32_t lod, const Neighbours &p_neighbours, const GDC_BlockTable &p_blocks,
+            GDC_SectionCells &r_cells) const;
+
+    std::array<Section, SECTION_COUNT> sections;
+    std::vector<uint8_t> light;
+    uint32_t light_dirty_sections = 0;
+    std::array<GDC_ChunkData *, 4> neighbours;
+};
+
+} // namespace godot
@@ -0,0 +1,314 @@
+#include "light_engine.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+namespace {
+
+constexpr int32_t SIZE = GDC_ChunkData::SIZE;
+constexpr int32_t HEIGHT = GDC_ChunkData::HEIGHT;
+constexpr int32_t MAX_LIGHT = GDC_ChunkData::MAX_LIGHT;
+constexpr int32_t FACE_COUNT = GDC_ChunkData::SECTION_FACE_COUNT;
+
+// Bit offset of each light channel within the packed byte.
+constexpr int32_t SKY_SHIFT = 4;
+constexpr int32_t BLOCK_SHIFT = 0;
+
+struct LightNode {
+    GDC_ChunkData *p_chunk = nullptr;
+    int32_t index = 0;     // native y, z, x order
+    int32_t level = 0;     // removal queue only: the level before it was cleared
+};
+
+inline int32_t get_level(const GDC_ChunkData &p_chunk, int32_t index, int32_t shift) {
+    return (p_chunk.get_light_index(index) >> shift) & 0x0f;
+}
+
+inline void set_level(GDC_ChunkData &r_chunk, int32_t index, int32_t shift, int32_t level) {
+    const uint8_t packed = r_chunk.get_light_index(index);
+    r_chunk.set_light_index(index, static_cast<uint8_t>((packed & ~(0x0f << shift)) | (level << shift)));
+}
+
+inline int32_t get_block_at_index(const GDC_ChunkData &p_chunk, int32_t index) {
+    return p_chunk.get_block(index % SIZE, index / (SIZE * SIZE), (index / SIZE) % SIZE);
+}
+
+// Moves from a block to its neighbour through a GDC_ChunkData::SECTION_FACE_*.
+// Fails above and below the world, at missing chunks, and at every chunk
+// border unless `cross_chunks` is set.
+inline bool step(GDC_ChunkData *p_chunk, int32_t index, int32_t face, bool cross_chunks, GDC_ChunkData *&r_chunk, int32_t &r_index) {
+    int32_t x = index % SIZE;
+    int32_t z = (index / SIZE) % SIZE;
+    int32_t y = index / (SIZE * SIZE);
+    r_chunk = p_chunk;
+
+    int32_t crossed = -1;
+    switch (face) {
+        case GDC_ChunkData::NEIGHBOUR_PX:
+            if (++x == SIZE) { x = 0; crossed = face; }
+            break;
+        case GDC_ChunkData::NEIGHBOUR_NX:
+            if (--x < 0) { x = SIZE - 1; crossed = face; }
+            break;
+        case GDC_ChunkData::NEIGHBOUR_PZ:
+            if (++z == SIZE) { z = 0; crossed = face; }
+            break;
+        case GDC_ChunkData::NEIGHBOUR_NZ:
+            if (--z < 0) { z = SIZE - 1; crossed = face; }
+            break;
+        case GDC_ChunkData::SECTION_FACE_PY:
+            if (++y == HEIGHT) { return false; }
+            break;
+        default:
+            if (--y < 0) { return false; }
+            break;
+    }
+
+    if (crossed != -1) {
+        if (!cross_chunks) { return false; }
+        r_chunk = p_chunk->get_neighbour(crossed);
+        if (r_chunk == nullptr) { return false; }
+    }
+    r_index = (y * SIZE + z) * SIZE + x;
+    return true;
+}
+
+// Full-strength sky light keeps its level on the way down.
+inline int32_t get_spread_level(int32_t level, int32_t shift, int32_t face) {
+    if (shift == SKY_SHIFT && face == GDC_ChunkData::SECTION_FACE_NY && level == MAX_LIGHT) {
+        return MAX_LIGHT;
+    }
+    return level - 1;
+}
+
+// Raises the light around every queued block to its level minus one, then
+// keeps going from each block that got brighter.
+void spread(std::vector<LightNode> &r_queue, int32_t shift, bool cross_chunks, const GDC_BlockTable &p_blocks) {
+    for (size_t head = 0; head < r_queue.size(); ++head) {
+        const LightNode node = r_queue[head];
+        const int32_t level = get_level(*node.p_chunk, node.index, shift);
+        if (level <= 1) { continue; }
+
+        for (int32_t face = 0; face < FACE_COUNT; ++face) {
+            GDC_ChunkData *p_next = nullptr;
+            int32_t next_index = 0;
+            if (!step(node.p_chunk, node.index, face, cross_chunks, p_next, next_index)) { continue; }
+            if (p_blocks.is_opaque(get_block_at_index(*p_next, next_index))) { continue; }
+
+            const int32_t next_level = get_spread_level(level, shift, face);
+            if (get_level(*p_next, next_index, shift) >= next_level) { continue; }
+
+            set_level(*p_next, next_index, shift, next_level);
+            r_queue.push_back({ p_next, next_index, 0 });
+        }
+    }
+    r_queue.clear();
+}
+
+// Clears every block whose light came through the queued (already cleared)
+// blocks. Brighter blocks met on the way are lit from elsewhere and go into
+// `r_add_queue`, to be spread back in afterwards.
+void remove(std::vector<LightNode> &r_queue, std::vector<LightNode> &r_add_queue, int32_t shift,
+        const GDC_BlockTable &p_blocks) {
+    for (size_t head = 0; head < r_queue.size(); ++head) {
+        const LightNode node = r_queue[head];
+
+        for (int32_t face = 0; face < FACE_COUNT; ++face) {
+            GDC_ChunkData *p_next = nullptr;
+            int32_t next_index = 0;
+            if (!step(node.p_chunk, node.index, face, true, p_next, next_index)) { continue; }
+
+            const int32_t next_level = get_level(*p_next, next_index, shift);
+            if (next_level == 0) { continue; }
+
+            const bool fed = next_level < node.level || get_spread_level(node.level, shift, face) == next_level;
+            if (!fed) {
+                r_add_queue.push_back({ p_next, next_index, 0 });
+                continue;
+            }
+
+            // Emitters keep their own light.
+            const int32_t emission = shift == BLOCK_SHIFT
+                    ? p_blocks.get_emission(get_block_at_index(*p_next, next_index))
+                    : 0;
+            if (emission >= next_level) {
+                r_add_queue.push_back({ p_next, next_index, 0 });
+                continue;
+            }
+
+            set_level(*p_next, next_index, shift, emission);
+            r_queue.push_back({ p_next, next_index, next_level });
+            if (emission > 0) {
+                r_add_queue.push_back({ p_next, next_index, 0 });
+            }
+        }
+    }
+    r_queue.clear();
+}
+
+// Queues the lit blocks along the border with neighbour `side`, on both sides.
+void queue_border(GDC_ChunkData &r_chunk, int32_t side, int32_t shift, std::vector<LightNode> &r_queue) {
+    GDC_ChunkData *p_neighbour = r_chunk.get_neighbour(side);
+    if (p_neighbour == nullptr) { return; }
+
+    const bool along_x = side == GDC_ChunkData::NEIGHBOUR_PX || side == GDC_ChunkData::NEIGHBOUR_NX;
+    const bool positive = side == GDC_ChunkData::NEIGHBOUR_PX || side == GDC_ChunkData::NEIGHBOUR_PZ;
+    const int32_t own_edge = positive ? SIZE - 1 : 0;
+    const int32_t other_edge = SIZE - 1 - own_edge;
+
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        for (int32_t i = 0; i < SIZE; ++i) {
+            const int32_t own_index = along_x ? (y * SIZE + i) * SIZE + own_edge : (y * SIZE + own_edge) * SIZE + i;
+            const int32_t other_index = along_x ? (y * SIZE + i) * SIZE + other_edge : (y * SIZE + other_edge) * SIZE + i;
+            if (get_level(r_chunk, own_index, shift) > 1) {
+                r_queue.push_back({ &r_chunk, own_index, 0 });
+            }
+            if (get_level(*p_neighbour, other_index, shift) > 1) {
+                r_queue.push_back({ p_neighbour, other_index, 0 });
+            }
+        }
+    }
+}
+
+thread_local std::vector<LightNode> add_queue;
+thread_local std::vector<LightNode> remove_queue;
+
+} // namespace
+
+void GDC_LightEngine::light_chunk(GDC_ChunkData &r_chunk, const GDC_BlockTable &p_blocks) {
+    thread_local std::vector<int32_t> ids;
+    ids.resize(GDC_ChunkData::BLOCK_COUNT);
+    r_chunk.store_blocks(ids.data());
+    r_chunk.fill_light(0);
+
+    // Open sky reaches down to the first opaque block of each column.
+    std::array<int32_t, SIZE * SIZE> sky_floor;
+    for (int32_t z = 0; z < SIZE; ++z) {
+        for (int32_t x = 0; x < SIZE; ++x) {
+            int32_t y = HEIGHT;
+            while (y > 0 && !p_blocks.is_opaque(ids[((y - 1) * SIZE + z) * SIZE + x])) {
+                --y;
+            }
+            sky_floor[z * SIZE + x] = y;
+        }
+    }
+
+    // Only the sky blocks beside a taller column can light anything new.
+    for (int32_t z = 0; z < SIZE; ++z) {
+        for (int32_t x = 0; x < SIZE; ++x) {
+            int32_t highest_neighbour = 0;
+            if (x > 0) { highest_neighbour = std::max(highest_neighbour, sky_floor[z * SIZE + x - 1]); }
+            if (x < SIZE - 1) { highest_neighbour = std::max(highest_neighbour, sky_floor[z * SIZE + x + 1]); }
+            if (z > 0) { highest_neighbour = std::max(highest_neighbour, sky_floor[(z - 1) * SIZE + x]); }
+            if (z < SIZE - 1) { highest_neighbour = std::max(highest_neighbour, sky_floor[(z + 1) * SIZE + x]); }
+
+            for (int32_t y = sky_floor[z * SIZE + x]; y < HEIGHT; ++y) {
+                const int32_t index = (y * SIZE + z) * SIZE + x;
+                set_level(r_chunk, index, SKY_SHIFT, MAX_LIGHT);
+                if (y < highest_neighbour) {
+                    add_queue.push_back({ &r_chunk, index, 0 });
+                }
+            }
+        }
+    }
+    spread(add_queue, SKY_SHIFT, false, p_blocks);
+
+    for (int32_t index = 0; index < GDC_ChunkData::BLOCK_COUNT; ++index) {
+        const uint8_t emission = p_blocks.get_emission(ids[index]);
+        if (emission > 0) {
+            set_level(r_chunk, index, BLOCK_SHIFT, std::min<int32_t>(emission, MAX_LIGHT));
+            add_queue.push_back({ &r_chunk, index, 0 });
+        }
+    }
+    spread(add_queue, BLOCK_SHIFT, false, p_blocks);
+}
+
+void GDC_LightEngine::stitch_chunk(GDC_ChunkData &r_chunk, const GDC_BlockTable &p_blocks) {
+    for (int32_t shift : { SKY_SHIFT, BLOCK_SHIFT }) {
+        for (int32_t side = 0; side < 4; ++side) {
+            queue_border(r_chunk, side, shift, add_queue);
+        }
+        spread(add_queue, shift, true, p_blocks);
+    }
+}
+
+void GDC_LightEngine::update_block(GDC_ChunkData &r_chunk, int32_t x, int32_t y, int32_t z, const GDC_BlockTable &p_blocks) {
+    if (x < 0 || y < 0 || z < 0 || x >= SIZE || y >= HEIGHT || z >= SIZE) { return; }
+
+    const int32_t index = (y * SIZE + z) * SIZE + x;
+    const int32_t id = r_chunk.get_block(x, y, z);
+
+    for (int32_t shift : { SKY_SHIFT, BLOCK_SHIFT }) {
+        // Take back whatever light the old block had or let through...
+        const int32_t old_level = get_level(r_chunk, index, shift);
+        if (old_level > 0) {
+            set_level(r_chunk, index, shift, 0);
+            remove_queue.push_back({ &r_chunk, index, old_level });
+            remove(remove_queue, add_queue, shift, p_blocks);
+        }
+
+        // ...then light the block again from its own emission and, if light
+        // can pass through it, from its surroundings.
+        const int32_t emission = shift == BLOCK_SHIFT ? std::min<int32_t>(p_blocks.get_emission(id), MAX_LIGHT) : 0;
+        if (emission > 0) {
+            set_level(r_chunk, index, shift, emission);
+            add_queue.push_back({ &r_chunk, index, 0 });
+        }
+        if (!p_blocks.is_opaque(id)) {
+            if (shift == SKY_SHIFT && y == HEIGHT - 1) {
+                set_level(r_chunk, index, shift, MAX_LIGHT);
+                add_queue.push_back({ &r_chunk, index, 0 });
+            }
+            for (int32_t face = 0; face < FACE_COUNT; ++face) {
+                GDC_ChunkData *p_next = nullptr;
+                int32_t next_index = 0;
+                if (step(&r_chunk, index, face, true, p_next, next_index) && get_level(*p_next, next_index, shift) > 0) {
+                    add_queue.push_back({ p_next, next_index, 0 });
+                }
+            }
+        }
+        spread(add_queue, shift, true, p_blocks);
+    }
+}
+
+void GDC_LightEngine::relight_area(GDC_ChunkData &r_chunk, const GDC_BlockTable &p_blocks) {
+    GDC_ChunkData *p_chunk = &r_chunk;
+    relight_areas(&p_chunk, 1, p_blocks);
+}
+
+void GDC_LightEngine::relight_areas(GDC_ChunkData *const *p_chunks, int32_t count, const GDC_BlockTable &p_blocks) {
+    thread_local std::vector<GDC_ChunkData *> area;
+    area.clear();
+    auto add_to_area = [](GDC_ChunkData *p_chunk) {
+        if (p_chunk != nullptr && std::find(area.begin(), area.end(), p_chunk) == area.end()) {
+            area.push_back(p_chunk);
+        }
+    };
+    for (int32_t i = 0; i < count; ++i) {
+        add_to_area(p_chunks[i]);
+        for (int32_t side : { GDC_ChunkData::NEIGHBOUR_PX, GDC_ChunkData::NEIGHBOUR_NX }) {
+            GDC_ChunkData *p_neighbour = p_chunks[i]->get_neighbour(side);
+            add_to_area(p_neighbour);
+            if (p_neighbour != nullptr) {
+                add_to_area(p_neighbour->get_neighbour(GDC_ChunkData::NEIGHBOUR_PZ));
+                add_to_area(p_neighbour->get_neighbour(GDC_ChunkData::NEIGHBOUR_NZ));
+            }
+        }
+        for (int32_t side : { GDC_ChunkData::NEIGHBOUR_PZ, GDC_ChunkData::NEIGHBOUR_NZ }) {
+            GDC_ChunkData *p_neighbour = p_chunks[i]->get_neighbour(side);
+            add_to_area(p_neighbour);
+            if (p_neighbour != nullptr) {
+                add_to_area(p_neighbour->get_neighbour(GDC_ChunkData::NEIGHBOUR_PX));
+                add_to_area(p_neighbour->get_neighbour(GDC_ChunkData::NEIGHBOUR_NX));
+            }
+        }
+    }
+
+    for (GDC_ChunkData *p_chunk : area) {
+        light_chunk(*p_chunk, p_blocks);
+    }
+    for (GDC_ChunkData *p_chunk : area) {
+        stitch_chunk(*p_chunk, p_blocks);
+    }
+}
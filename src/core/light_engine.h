@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "block_table.h"
+#include "chunk_data.h"
+
+namespace godot {
+
+// Sky and block light for GDC_ChunkData, spread by breadth-first flood fill.
+// Light loses one level per block, except sky light at full strength, which
+// falls straight down without fading. Light passes through air and the blocks
+// the GDC_BlockTable marks as see-through, and stops at opaque ones; a block
+// that emits light keeps its emission as its own block light.
+//
+// Edits are applied incrementally: light that depended on a changed block is
+// first cleared along a removal queue, then whatever still reaches the cleared
+// blocks is spread back in, so the cost follows the size of the change rather
+// than the chunk.
+class GDC_LightEngine {
+public:
+    // Lights the chunk on its own: open sky from the top down, then its
+    // emitters, spread within the chunk. Neighbours are neither read nor
+    // written, so unlinked chunks can be lit in parallel on worker threads.
+    static void light_chunk(GDC_ChunkData &r_chunk, const GDC_BlockTable &p_blocks);
+
+    // Spreads light across the borders with every linked neighbour, in both
+    // directions. Call once a chunk lit by light_chunk() has been linked.
+    static void stitch_chunk(GDC_ChunkData &r_chunk, const GDC_BlockTable &p_blocks);
+
+    // Updates the light after the block at a chunk-local position changed.
+    static void update_block(GDC_ChunkData &r_chunk, int32_t x, int32_t y, int32_t z, const GDC_BlockTable &p_blocks);
+
+    // Relights the chunk and the eight chunks around it from scratch. Light
+    // fades within MAX_LIGHT blocks, so nothing further away can depend on the
+    // chunk's blocks; meant for bulk edits where per-block updates cost more.
+    static void relight_area(GDC_ChunkData &r_chunk, const GDC_BlockTable &p_blocks);
+    // relight_area() for several chunks at once: each chunk in the union of
+    // their areas is relit once, however many of the areas it is part of.
+    static void relight_areas(GDC_ChunkData *const *p_chunks, int32_t count, const GDC_BlockTable &p_blocks);
+};
+
+} // namespace godot
@@ -0,0 +1,145 @@
+#include "noise.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+static const int32_t ROW_BATCH = 64;
+
+static inline uint32_t hash2(int32_t x, int32_t z, uint32_t seed) {
+    uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8da6b343u) ^ (static_cast<uint32_t>(z) * 0xcb1ab31fu);
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    return h ^ (h >> 15);
+}
+
+static inline uint32_t hash3(int32_t x, int32_t y, int32_t z, uint32_t seed) {
+    uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8da6b343u) ^ (static_cast<uint32_t>(y) * 0xd8163841u) ^ (static_cast<uint32_t>(z) * 0xcb1ab31fu);
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    return h ^ (h >> 15);
+}
+
+static inline float fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+// One of the four diagonal directions, picked with selects rather than branches.
+static inline float grad2(uint32_t h, float x, float z) {
+    return ((h & 1) ? -x : x) + ((h & 2) ? -z : z);
+}
+
+// Perlin's improved-noise gradient set (the 12 cube edge directions).
+static inline float grad3(uint32_t h, float x, float y, float z) {
+    const uint32_t g = h & 15;
+    const float u = g < 8 ? x : y;
+    const float v = g < 4 ? y : (g == 12 || g == 14 ? x : z);
+    return ((g & 1) ? -u : u) + ((g & 2) ? -v : v);
+}
+
+static inline float noise_2d(float x, float z, uint32_t seed) {
+    const float fx = std::floor(x);
+    const float fz = std::floor(z);
+    const int32_t ix = static_cast<int32_t>(fx);
+    const int32_t iz = static_cast<int32_t>(fz);
+    const float tx = x - fx;
+    const float tz = z - fz;
+
+    const float n00 = grad2(hash2(ix, iz, seed), tx, tz);
+    const float n10 = grad2(hash2(ix + 1, iz, seed), tx - 1.0f, tz);
+    const float n01 = grad2(hash2(ix, iz + 1, seed), tx, tz - 1.0f);
+    const float n11 = grad2(hash2(ix + 1, iz + 1, seed), tx - 1.0f, tz - 1.0f);
+
+    const float u = fade(tx);
+    return lerp(lerp(n00, n10, u), lerp(n01, n11, u), fade(tz));
+}
+
+static inline float noise_3d(float x, float y, float z, uint32_t seed) {
+    const float fx = std::floor(x);
+    const float fy = std::floor(y);
+    const float fz = std::floor(z);
+    const int32_t ix = static_cast<int32_t>(fx);
+    const int32_t iy = static_cast<int32_t>(fy);
+    const int32_t iz = static_cast<int32_t>(fz);
+    const float tx = x - fx;
+    const float ty = y - fy;
+    const float tz = z - fz;
+
+    const float n000 = grad3(hash3(ix, iy, iz, seed), tx, ty, tz);
+    const float n100 = grad3(hash3(ix + 1, iy, iz, seed), tx - 1.0f, ty, tz);
+    const float n010 = grad3(hash3(ix, iy + 1, iz, seed), tx, ty - 1.0f, tz);
+    const float n110 = grad3(hash3(ix + 1, iy + 1, iz, seed), tx - 1.0f, ty - 1.0f, tz);
+    const float n001 = grad3(hash3(ix, iy, iz + 1, seed), tx, ty, tz - 1.0f);
+    const float n101 = grad3(hash3(ix + 1, iy, iz + 1, seed), tx - 1.0f, ty, tz - 1.0f);
+    const float n011 = grad3(hash3(ix, iy + 1, iz + 1, seed), tx, ty - 1.0f, tz - 1.0f);
+    const float n111 = grad3(hash3(ix + 1, iy + 1, iz + 1, seed), tx - 1.0f, ty - 1.0f, tz - 1.0f);
+
+    const float u = fade(tx);
+    const float v = fade(ty);
+    const float x00 = lerp(n000, n100, u);
+    const float x10 = lerp(n010, n110, u);
+    const float x01 = lerp(n001, n101, u);
+    const float x11 = lerp(n011, n111, u);
+    return lerp(lerp(x00, x10, v), lerp(x01, x11, v), fade(tz));
+}
+
+float GDC_Noise::sample_2d(float x, float z) const {
+    return noise_2d(x, z, seed);
+}
+
+float GDC_Noise::sample_3d(float x, float y, float z) const {
+    return noise_3d(x, y, z, seed);
+}
+
+void GDC_Noise::sample_row_2d(float x, float z, float step, int32_t count, float *r_out) const {
+    const uint32_t s = seed;
+    for (int32_t i = 0; i < count; ++i) {
+        r_out[i] = noise_2d(x + step * static_cast<float>(i), z, s);
+    }
+}
+
+void GDC_Noise::sample_row_3d(float x, float y, float z, float step, int32_t count, float *r_out) const {
+    const uint32_t s = seed;
+    for (int32_t i = 0; i < count; ++i) {
+        r_out[i] = noise_3d(x + step * static_cast<float>(i), y, z, s);
+    }
+}
+
+void GDC_Noise::fbm_row_2d(float x, float z, float step, int32_t count, int32_t octaves, float gain, float *r_out) const {
+    std::fill_n(r_out, count, 0.0f);
+
+    float octave_row[ROW_BATCH];
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
+    float total_amplitude = 0.0f;
+    for (int32_t octave = 0; octave < octaves; ++octave) {
+        // Each octave gets its own seed so layers don't line up at the origin.
+        const GDC_Noise layer(seed + static_cast<uint32_t>(octave) * 0x9e3779b9u);
+        for (int32_t start = 0; start < count; start += ROW_BATCH) {
+            const int32_t batch = std::min(ROW_BATCH, count - start);
+            layer.sample_row_2d((x + step * start) * frequency, z * frequency, step * frequency, batch, octave_row);
+            for (int32_t i = 0; i < batch; ++i) {
+                r_out[start + i] += octave_row[i] * amplitude;
+            }
+        }
+        total_amplitude += amplitude;
+        frequency *= 2.0f;
+        amplitude *= gain;
+    }
+
+    if (total_amplitude > 0.0f) {
+        const float inv = 1.0f / total_amplitude;
+        for (int32_t i = 0; i < count; ++i) {
+            r_out[i] *= inv;
+        }
+    }
+}
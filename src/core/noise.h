@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace godot {
+
+// Seeded gradient (Perlin-style) noise. Gradients come from an integer hash of
+// the lattice point instead of a permutation table, so the row samplers have no
+// table lookups or data-dependent branches and the compiler can vectorize them.
+// Output is roughly in [-1, 1] and depends only on the seed and the inputs.
+class GDC_Noise {
+public:
+    explicit GDC_Noise(uint32_t p_seed = 0) :
+            seed(p_seed) {}
+
+    float sample_2d(float x, float z) const;
+    float sample_3d(float x, float y, float z) const;
+
+    // Samples `count` points spaced `step` apart along x, starting at (x, z) or (x, y, z).
+    void sample_row_2d(float x, float z, float step, int32_t count, float *r_out) const;
+    void sample_row_3d(float x, float y, float z, float step, int32_t count, float *r_out) const;
+
+    // Fractal sum of `octaves` layers, each at double the frequency and `gain`
+    // times the amplitude of the previous one, normalised back to about [-1, 1].
+    void fbm_row_2d(float x, float z, float step, int32_t count, int32_t octaves, float gain, float *r_out) const;
+
+private:
+    uint32_t seed;
+};
+
+} // namespace godot
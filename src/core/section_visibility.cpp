@@ -0,0 +1,54 @@
+#include "section_visibility.h"
+
+using namespace godot;
+
+// Step to the next section through each SECTION_FACE_*, as (chunk x, section,
+// chunk z).
+static const int32_t FACE_OFFSETS[GDC_ChunkData::SECTION_FACE_COUNT][3] = {
+    { 1, 0, 0 }, { -1, 0, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 0, -1, 0 }
+};
+
+bool GDC_SectionVisibility::search(int32_t chunk_x, int32_t chunk_z, int32_t section, LinksLookup p_lookup, const void *p_userdata) {
+    clear();
+    if (section < 0 || section >= GDC_ChunkData::SECTION_COUNT) { return false; }
+    if (p_lookup(chunk_x, chunk_z, section, -1, p_userdata) < 0) { return false; }
+
+    queue.push_back({ chunk_x, chunk_z, section, GDC_ChunkData::ALL_SECTION_FACES, 0 });
+    visible[make_key(chunk_x, chunk_z)] = 1 << section;
+    visible_section_count = 1;
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Step step = queue[head];
+        for (int32_t face = 0; face < GDC_ChunkData::SECTION_FACE_COUNT; ++face) {
+            if (!(step.exits & (1 << face)) || (step.directions & (1 << (face ^ 1)))) { continue; }
+
+            const int32_t next_x = step.chunk_x + FACE_OFFSETS[face][0];
+            const int32_t next_section = step.section + FACE_OFFSETS[face][1];
+            const int32_t next_z = step.chunk_z + FACE_OFFSETS[face][2];
+            if (next_section < 0 || next_section >= GDC_ChunkData::SECTION_COUNT) { continue; }
+
+            const uint64_t key = make_key(next_x, next_z);
+            auto found = visible.find(key);
+            if (found != visible.end() && (found->second & (1 << next_section))) { continue; }
+
+            const int32_t exits = p_lookup(next_x, next_z, next_section, face ^ 1, p_userdata);
+            if (exits < 0) { continue; }
+
+            visible[key] |= 1 << next_section;
+            ++visible_section_count;
+            queue.push_back({ next_x, next_z, next_section, static_cast<uint8_t>(exits), static_cast<uint8_t>(step.directions | (1 << face)) });
+        }
+    }
+    return true;
+}
+
+void GDC_SectionVisibility::clear() {
+    visible.clear();
+    queue.clear();
+    visible_section_count = 0;
+}
+
+uint8_t GDC_SectionVisibility::get_visible_sections(int32_t chunk_x, int32_t chunk_z) const {
+    auto found = visible.find(make_key(chunk_x, chunk_z));
+    return found != visible.end() ? found->second : 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk_data.h"
+
+namespace godot {
+
+// Cave culling: finds the chunk sections that can be seen from a start section
+// by walking the face links recorded when each section was meshed (see
+// GDC_VoxelMesher::compute_face_links()). Sections it does not reach can be
+// hidden.
+class GDC_SectionVisibility {
+public:
+    // Returns the SECTION_FACE_* bits linked to `entry_face` of the section, or
+    // -1 if its chunk is not loaded.
+    using LinksLookup = int32_t (*)(int32_t p_chunk_x, int32_t p_chunk_z, int32_t section, int32_t entry_face, const void *p_userdata);
+
+    // Breadth-first search over sections from the start section. A section is
+    // left through a face only if that face is linked to the face it was
+    // entered by, and never in the direction opposite to one already taken, so
+    // the search cannot wrap around solid terrain and come back into view from
+    // behind. Returns false, reaching nothing, if the start chunk is not loaded.
+    bool search(int32_t chunk_x, int32_t chunk_z, int32_t section, LinksLookup p_lookup, const void *p_userdata);
+    void clear();
+
+    // Bit i is set when section i of the chunk was reached.
+    uint8_t get_visible_sections(int32_t chunk_x, int32_t chunk_z) const;
+    int32_t get_visible_chunk_count() const { return static_cast<int32_t>(visible.size()); }
+    int32_t get_visible_section_count() const { return visible_section_count; }
+
+private:
+    struct Step {
+        int32_t chunk_x = 0;
+        int32_t chunk_z = 0;
+        int32_t section = 0;
+        uint8_t exits = 0;      // faces linked to the one the section was entered by
+        uint8_t directions = 0; // SECTION_FACE_* bits travelled so far
+    };
+
+    static uint64_t make_key(int32_t chunk_x, int32_t chunk_z) {
+        return (uint64_t(uint32_t(chunk_x)) << 32) | uint32_t(chunk_z);
+    }
+
+    std::unordered_map<uint64_t, uint8_t> visible;
+    std::vector<Step> queue;
+    int32_t visible_section_count = 0;
+};
+
+} // namespace godot
@@ -0,0 +1,64 @@
+#include "terrain_column.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "noise.h"
+
+using namespace godot;
+
+void GDC_TerrainColumn::generate(int32_t chunk_x, int32_t chunk_z, int32_t *r_ids) const {
+    constexpr int32_t SIZE = GDC_ChunkData::SIZE;
+    constexpr int32_t AREA = SIZE * SIZE;
+
+    std::fill_n(r_ids, GDC_ChunkData::BLOCK_COUNT, 0);
+
+    const GDC_Noise height_noise(static_cast<uint32_t>(seed));
+    const GDC_Noise cave_noise(static_cast<uint32_t>(seed) ^ 0x5bd1e995u);
+
+    const float world_x = static_cast<float>(chunk_x * SIZE);
+    const float world_z = static_cast<float>(chunk_z * SIZE);
+
+    float height_row[SIZE];
+    int32_t heights[AREA];
+    int32_t max_height = 0;
+    for (int32_t z = 0; z < SIZE; ++z) {
+        height_noise.fbm_row_2d(world_x * height_frequency, (world_z + z) * height_frequency, height_frequency,
+                SIZE, height_octaves, height_gain, height_row);
+        for (int32_t x = 0; x < SIZE; ++x) {
+            const int32_t h = base_height + static_cast<int32_t>(std::lround(height_row[x] * height_amplitude));
+            heights[z * SIZE + x] = std::clamp(h, 1, GDC_ChunkData::HEIGHT - 1);
+            max_height = std::max(max_height, heights[z * SIZE + x]);
+        }
+    }
+
+    float cave_row[SIZE];
+    for (int32_t y = 0; y <= max_height; ++y) {
+        int32_t *p_layer = r_ids + y * AREA;
+        // The bottom layer is never carved so the world always has a floor.
+        const bool carve = caves_enabled && y > 0;
+
+        for (int32_t z = 0; z < SIZE; ++z) {
+            if (carve) {
+                cave_noise.sample_row_3d(world_x * cave_frequency, y * cave_frequency, (world_z + z) * cave_frequency,
+                        cave_frequency, SIZE, cave_row);
+            }
+
+            for (int32_t x = 0; x < SIZE; ++x) {
+                const int32_t h = heights[z * SIZE + x];
+                if (y > h) { continue; }
+
+                int32_t id = stone;
+                if (y == h) {
+                    id = grass;
+                } else if (y >= h - dirt_depth) {
+                    id = dirt;
+                }
+                if (carve && cave_row[x] > cave_threshold) {
+                    id = 0;
+                }
+                p_layer[z * SIZE + x] = id;
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "chunk_data.h"
+
+namespace godot {
+
+// The terrain of GDC_TerrainGenerator without the engine: a seeded heightmap of
+// layered stone/dirt/grass columns with 3D-noise caves carved out of them. The
+// settings are plain values copied from the generator and the block ids are
+// resolved beforehand, so columns can be generated on any thread.
+struct GDC_TerrainColumn {
+    int32_t seed = 1337;
+
+    int32_t base_height = 32;
+    float height_amplitude = 16.0f;
+    float height_frequency = 0.01f;
+    int32_t height_octaves = 4;
+    float height_gain = 0.5f;
+    int32_t dirt_depth = 3;
+
+    bool caves_enabled = true;
+    float cave_frequency = 0.06f;
+    float cave_threshold = 0.45f;
+
+    int32_t stone = 0;
+    int32_t dirt = 0;
+    int32_t grass = 0;
+
+    // Writes the chunk's BLOCK_COUNT ids in the native y, z, x order.
+    void generate(int32_t chunk_x, int32_t chunk_z, int32_t *r_ids) const;
+};
+
+} // namespace godot
@@ -0,0 +1,85 @@
+#include "tick_scheduler.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+bool GDC_TickScheduler::schedule(int32_t chunk_x, int32_t chunk_z, int32_t index, int64_t due) {
+    if (index < 0 || index >= GDC_ChunkData::BLOCK_COUNT) { return false; }
+
+    const uint64_t key = make_key(chunk_x, chunk_z);
+    Bucket &bucket = buckets[key];
+    if (bucket.pending.empty()) {
+        bucket.pending.assign(GDC_ChunkData::BLOCK_COUNT / 64, 0);
+    }
+    uint64_t &word = bucket.pending[index >> 6];
+    const uint64_t bit = uint64_t(1) << (index & 63);
+    if (word & bit) { return false; }
+    word |= bit;
+
+    const bool earliest = bucket.heap.empty() || due < bucket.heap.front().due;
+    bucket.heap.push_back({ due, next_order++, index });
+    std::push_heap(bucket.heap.begin(), bucket.heap.end(), is_entry_later);
+    if (earliest) {
+        wakeups.push_back({ due, key });
+        std::push_heap(wakeups.begin(), wakeups.end(), is_wakeup_later);
+    }
+    ++pending_count;
+    return true;
+}
+
+bool GDC_TickScheduler::is_scheduled(int32_t chunk_x, int32_t chunk_z, int32_t index) const {
+    if (index < 0 || index >= GDC_ChunkData::BLOCK_COUNT) { return false; }
+    auto found = buckets.find(make_key(chunk_x, chunk_z));
+    if (found == buckets.end()) { return false; }
+    return (found->second.pending[index >> 6] >> (index & 63)) & 1;
+}
+
+void GDC_TickScheduler::pop_due(int64_t now, std::vector<Tick> &r_ticks) {
+    const size_t first = r_ticks.size();
+    while (!wakeups.empty() && wakeups.front().due <= now) {
+        const uint64_t key = wakeups.front().key;
+        std::pop_heap(wakeups.begin(), wakeups.end(), is_wakeup_later);
+        wakeups.pop_back();
+
+        auto found = buckets.find(key);
+        if (found == buckets.end()) { continue; }
+        Bucket &bucket = found->second;
+        if (bucket.heap.empty() || bucket.heap.front().due > now) { continue; }
+
+        const int32_t chunk_x = int32_t(uint32_t(key >> 32));
+        const int32_t chunk_z = int32_t(uint32_t(key));
+        while (!bucket.heap.empty() && bucket.heap.front().due <= now) {
+            const Entry entry = bucket.heap.front();
+            std::pop_heap(bucket.heap.begin(), bucket.heap.end(), is_entry_later);
+            bucket.heap.pop_back();
+            bucket.pending[entry.index >> 6] &= ~(uint64_t(1) << (entry.index & 63));
+            r_ticks.push_back({ entry.due, entry.order, chunk_x, chunk_z, entry.index });
+            --pending_count;
+        }
+
+        if (bucket.heap.empty()) {
+            buckets.erase(found);
+        } else {
+            wakeups.push_back({ bucket.heap.front().due, key });
+            std::push_heap(wakeups.begin(), wakeups.end(), is_wakeup_later);
+        }
+    }
+
+    std::sort(r_ticks.begin() + first, r_ticks.end(), [](const Tick &a, const Tick &b) {
+        return a.due != b.due ? a.due < b.due : a.order < b.order;
+    });
+}
+
+void GDC_TickScheduler::clear_chunk(int32_t chunk_x, int32_t chunk_z) {
+    auto found = buckets.find(make_key(chunk_x, chunk_z));
+    if (found == buckets.end()) { return; }
+    pending_count -= static_cast<int64_t>(found->second.heap.size());
+    buckets.erase(found);
+}
+
+void GDC_TickScheduler::clear() {
+    buckets.clear();
+    wakeups.clear();
+    pending_count = 0;
+}
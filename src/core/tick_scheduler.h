@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk_data.h"
+
+namespace godot {
+
+// Block updates scheduled for a later game tick. Ticks are bucketed by chunk,
+// each bucket a min-heap on the due tick, so a chunk's ticks are dropped with
+// it and popping only visits chunks that have something due: the cost follows
+// the number of scheduled blocks, not the size of the world. A block has at
+// most one pending tick; scheduling it again keeps the existing one, even if
+// the new one would come due sooner.
+class GDC_TickScheduler {
+public:
+    struct Tick {
+        int64_t due = 0;
+        uint64_t order = 0; // ties on `due` run in the order they were scheduled
+        int32_t chunk_x = 0;
+        int32_t chunk_z = 0;
+        int32_t index = 0; // in the native y, z, x order of GDC_ChunkData
+    };
+
+    // Returns false when the block already has a pending tick.
+    bool schedule(int32_t chunk_x, int32_t chunk_z, int32_t index, int64_t due);
+    bool is_scheduled(int32_t chunk_x, int32_t chunk_z, int32_t index) const;
+    // Removes every tick due at or before `now` and appends them to r_ticks,
+    // sorted by due tick and then scheduling order.
+    void pop_due(int64_t now, std::vector<Tick> &r_ticks);
+
+    void clear_chunk(int32_t chunk_x, int32_t chunk_z);
+    void clear();
+
+    int64_t get_pending_count() const { return pending_count; }
+    int32_t get_active_chunk_count() const { return static_cast<int32_t>(buckets.size()); }
+
+private:
+    struct Entry {
+        int64_t due = 0;
+        uint64_t order = 0;
+        int32_t index = 0;
+    };
+
+    struct Bucket {
+        std::vector<Entry> heap;
+        std::vector<uint64_t> pending; // one bit per block of the chunk
+    };
+
+    // When a bucket may next have a tick due. A bucket's earliest tick always
+    // has a wakeup; wakeups left over from ticks that were popped or cleared
+    // are skipped.
+    struct Wakeup {
+        int64_t due = 0;
+        uint64_t key = 0;
+    };
+
+    // std heaps keep the largest element in front; these order them the other way.
+    static bool is_entry_later(const Entry &a, const Entry &b) { return a.due != b.due ? a.due > b.due : a.order > b.order; }
+    static bool is_wakeup_later(const Wakeup &a, const Wakeup &b) { return a.due > b.due; }
+
+    static uint64_t make_key(int32_t chunk_x, int32_t chunk_z) {
+        return (uint64_t(uint32_t(chunk_x)) << 32) | uint32_t(chunk_z);
+    }
+
+    std::unordered_map<uint64_t, Bucket> buckets;
+    std::vector<Wakeup> wakeups; // min-heap on `due`
+    uint64_t next_order = 0;
+    int64_t pending_count = 0;
+};
+
+} // namespace godot
@@ -0,0 +1,272 @@
+#include "voxel_mesher.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+// A face is lit by the air or see-through cell in front of it.
+static inline int32_t get_face_light(const GDC_SectionCells &p_cells, int32_t x, int32_t y, int32_t z, int32_t face) {
+    const std::array<int32_t, 3> &normal = GDC_VoxelMesher::FACE_NORMALS[face];
+    const uint8_t light = p_cells.get_light(x + normal[0], y + normal[1], z + normal[2]);
+    return std::max(light >> 4, light & 0x0f);
+}
+
+// Per face and corner, the offsets from a cell to the two side cells and the
+// diagonal cell around that corner, all in the layer in front of the face.
+using AoOffsets = std::array<std::array<std::array<std::array<int32_t, 3>, 3>, 4>, GDC_VoxelMesher::FACE_COUNT>;
+
+static constexpr AoOffsets make_ao_offsets() {
+    AoOffsets offsets = {};
+    for (int32_t face = 0; face < GDC_VoxelMesher::FACE_COUNT; ++face) {
+        const int32_t axis = GDC_VoxelMesher::FACE_AXIS[face];
+        const int32_t u_axis = (axis + 1) % 3;
+        const int32_t v_axis = (axis + 2) % 3;
+        for (int32_t corner = 0; corner < 4; ++corner) {
+            const std::array<int32_t, 3> &position = GDC_VoxelMesher::FACE_CORNERS[face][corner];
+            for (int32_t i = 0; i < 3; ++i) {
+                offsets[face][corner][i] = GDC_VoxelMesher::FACE_NORMALS[face];
+            }
+            offsets[face][corner][0][u_axis] += position[u_axis] * 2 - 1;
+            offsets[face][corner][1][v_axis] += position[v_axis] * 2 - 1;
+            offsets[face][corner][2][u_axis] += position[u_axis] * 2 - 1;
+            offsets[face][corner][2][v_axis] += position[v_axis] * 2 - 1;
+        }
+    }
+    return offsets;
+}
+
+static constexpr AoOffsets AO_OFFSETS = make_ao_offsets();
+
+// Whether each cell of a GDC_SectionCells is opaque, border included, in the
+// same padded layout. AO samples opacity twelve times per face, so it is looked
+// up in the block table once per cell instead.
+struct OpaqueCells {
+    const uint8_t *p_data = nullptr;
+    int32_t padded = 0;
+
+    inline bool get(int32_t x, int32_t y, int32_t z) const {
+        return p_data[((y + 1) * padded * padded) + ((z + 1) * padded) + (x + 1)] != 0;
+    }
+};
+
+static OpaqueCells capture_opacity(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks) {
+    thread_local std::vector<uint8_t> opaque;
+    opaque.resize(p_cells.blocks.size());
+    for (size_t i = 0; i < opaque.size(); ++i) {
+        opaque[i] = p_blocks.is_opaque(p_cells.blocks[i]) ? 1 : 0;
+    }
+    return { opaque.data(), p_cells.size + 2 };
+}
+
+// Opaque neighbours hide a face outright; only see-through ones need the block
+// table's culling matrix.
+static inline bool is_face_exposed(const GDC_SectionCells &p_cells, const OpaqueCells &p_opaque, const GDC_BlockTable &p_blocks,
+        int32_t id, int32_t x, int32_t y, int32_t z, int32_t face) {
+    const std::array<int32_t, 3> &normal = GDC_VoxelMesher::FACE_NORMALS[face];
+    if (p_opaque.get(x + normal[0], y + normal[1], z + normal[2])) { return false; }
+    const int32_t neighbour_id = p_cells.get_block(x + normal[0], y + normal[1], z + normal[2]);
+    return neighbour_id <= 0 || !p_blocks.is_face_culled(id, neighbour_id);
+}
+
+// Classic three-neighbour voxel AO. Every side and diagonal cell lies in the
+// section's one-cell border, which capture_section() fills from the chunks
+// across each face and corner, so AO is continuous across chunk borders.
+static inline std::array<uint8_t, 4> get_face_ao(const OpaqueCells &p_opaque, int32_t x, int32_t y, int32_t z, int32_t face) {
+    std::array<uint8_t, 4> ao;
+    for (int32_t corner = 0; corner < 4; ++corner) {
+        const std::array<std::array<int32_t, 3>, 3> &offsets = AO_OFFSETS[face][corner];
+        const bool side_u = p_opaque.get(x + offsets[0][0], y + offsets[0][1], z + offsets[0][2]);
+        const bool side_v = p_opaque.get(x + offsets[1][0], y + offsets[1][1], z + offsets[1][2]);
+        const bool diagonal = p_opaque.get(x + offsets[2][0], y + offsets[2][1], z + offsets[2][2]);
+        ao[corner] = side_u && side_v ? 0 : static_cast<uint8_t>(GDC_VoxelMesher::MAX_AO - side_u - side_v - diagonal);
+    }
+    return ao;
+}
+
+void GDC_VoxelMesher::build_naive(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks, std::vector<GDC_MeshQuad> &r_quads) {
+    const int32_t scale = p_cells.scale;
+    const OpaqueCells opaque = capture_opacity(p_cells, p_blocks);
+    for (int32_t y = 0; y < p_cells.height; ++y) {
+        for (int32_t z = 0; z < p_cells.size; ++z) {
+            for (int32_t x = 0; x < p_cells.size; ++x) {
+                const int32_t id = p_cells.get_block(x, y, z);
+                if (id <= 0) { continue; }
+
+                for (int32_t face = 0; face < FACE_COUNT; ++face) {
+                    if (!is_face_exposed(p_cells, opaque, p_blocks, id, x, y, z, face)) {
+                        continue;
+                    }
+                    GDC_MeshQuad &quad = r_quads.emplace_back();
+                    quad.origin = { x * scale, y * scale, z * scale };
+                    quad.size = { scale, scale, scale };
+                    quad.id = id;
+                    quad.face = face;
+                    quad.light = get_face_light(p_cells, x, y, z, face);
+                    quad.ao = get_face_ao(opaque, x, y, z, face);
+                }
+            }
+        }
+    }
+}
+
+void GDC_VoxelMesher::build_greedy(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks, std::vector<GDC_MeshQuad> &r_quads) {
+    const std::array<int32_t, 3> dims = { p_cells.size, p_cells.height, p_cells.size };
+    const int32_t scale = p_cells.scale;
+    const OpaqueCells opaque = capture_opacity(p_cells, p_blocks);
+
+    // Merge key per cell of the current slice: the block id in bits 0-23, the
+    // face's light level in bits 24-27 and its corner AO, two bits per corner,
+    // in bits 28-35; 0 means "no exposed face here". Kept per thread so
+    // repeated builds do not allocate.
+    thread_local std::vector<uint64_t> mask;
+
+    for (int32_t face = 0; face < FACE_COUNT; ++face) {
+        const int32_t axis = FACE_AXIS[face];
+        const int32_t u_axis = (axis + 1) % 3;
+        const int32_t v_axis = (axis + 2) % 3;
+        const int32_t u_size = dims[u_axis];
+        const int32_t v_size = dims[v_axis];
+
+        // Corners pairing up across u (same v) and across v (same u); a face can
+        // only stretch along u if the AO of each such pair matches, and likewise
+        // for v.
+        std::array<std::array<int32_t, 2>, 2> u_pairs;
+        std::array<std::array<int32_t, 2>, 2> v_pairs;
+        for (int32_t corner = 0; corner < 4; ++corner) {
+            const std::array<int32_t, 3> &position = FACE_CORNERS[face][corner];
+            u_pairs[position[v_axis]][position[u_axis]] = corner;
+            v_pairs[position[u_axis]][position[v_axis]] = corner;
+        }
+
+        mask.assign(static_cast<size_t>(u_size) * v_size, 0);
+
+        for (int32_t slice = 0; slice < dims[axis]; ++slice) {
+            std::array<int32_t, 3> pos;
+            pos[axis] = slice;
+
+            for (int32_t v = 0; v < v_size; ++v) {
+                pos[v_axis] = v;
+                for (int32_t u = 0; u < u_size; ++u) {
+                    pos[u_axis] = u;
+                    const int32_t id = p_cells.get_block(pos[0], pos[1], pos[2]);
+                    if (id <= 0 || !is_face_exposed(p_cells, opaque, p_blocks, id, pos[0], pos[1], pos[2], face)) {
+                        mask[v * u_size + u] = 0;
+                        continue;
+                    }
+                    const std::array<uint8_t, 4> ao = get_face_ao(opaque, pos[0], pos[1], pos[2], face);
+                    uint64_t key = static_cast<uint64_t>(id) | (static_cast<uint64_t>(get_face_light(p_cells, pos[0], pos[1], pos[2], face)) << 24);
+                    for (int32_t corner = 0; corner < 4; ++corner) {
+                        key |= static_cast<uint64_t>(ao[corner]) << (28 + corner * 2);
+                    }
+                    mask[v * u_size + u] = key;
+                }
+            }
+
+            for (int32_t v = 0; v < v_size; ++v) {
+                for (int32_t u = 0; u < u_size;) {
+                    const uint64_t key = mask[v * u_size + u];
+                    if (key == 0) {
+                        ++u;
+                        continue;
+                    }
+
+                    std::array<uint8_t, 4> ao;
+                    for (int32_t corner = 0; corner < 4; ++corner) {
+                        ao[corner] = (key >> (28 + corner * 2)) & 3;
+                    }
+                    const bool u_flat = ao[u_pairs[0][0]] == ao[u_pairs[0][1]] && ao[u_pairs[1][0]] == ao[u_pairs[1][1]];
+                    const bool v_flat = ao[v_pairs[0][0]] == ao[v_pairs[0][1]] && ao[v_pairs[1][0]] == ao[v_pairs[1][1]];
+
+                    int32_t width = 1;
+                    while (u_flat && u + width < u_size && mask[v * u_size + u + width] == key) {
+                        ++width;
+                    }
+
+                    int32_t height = 1;
+                    for (; v_flat && v + height < v_size; ++height) {
+                        const uint64_t *row = &mask[(v + height) * u_size + u];
+                        if (!std::all_of(row, row + width, [key](uint64_t cell) { return cell == key; })) {
+                            break;
+                        }
+                    }
+
+                    for (int32_t dv = 0; dv < height; ++dv) {
+                        std::fill_n(&mask[(v + dv) * u_size + u], width, 0);
+                    }
+
+                    GDC_MeshQuad &quad = r_quads.emplace_back();
+                    quad.origin[axis] = slice * scale;
+                    quad.origin[u_axis] = u * scale;
+                    quad.origin[v_axis] = v * scale;
+                    quad.size[axis] = scale;
+                    quad.size[u_axis] = width * scale;
+                    quad.size[v_axis] = height * scale;
+                    quad.id = static_cast<int32_t>(key & 0xffffff);
+                    quad.face = face;
+                    quad.light = static_cast<int32_t>((key >> 24) & 0x0f);
+                    quad.ao = ao;
+                    u += width;
+                }
+            }
+        }
+    }
+}
+
+void GDC_VoxelMesher::compute_face_links(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks, GDC_ChunkData::FaceLinks &r_links) {
+    if (p_cells.scale > 1) {
+        r_links = GDC_ChunkData::make_face_links(GDC_ChunkData::ALL_SECTION_FACES);
+        return;
+    }
+
+    const int32_t size = p_cells.size;
+    const int32_t height = p_cells.height;
+    r_links = GDC_ChunkData::make_face_links(0);
+
+    thread_local std::vector<uint8_t> visited;
+    thread_local std::vector<int32_t> stack;
+    visited.assign(static_cast<size_t>(size) * size * height, 0);
+    stack.clear();
+
+    for (int32_t start = 0; start < static_cast<int32_t>(visited.size()); ++start) {
+        if (visited[start]) { continue; }
+        visited[start] = 1;
+        if (p_blocks.is_opaque(p_cells.get_block(start % size, start / (size * size), (start / size) % size))) { continue; }
+
+        uint8_t touched = 0;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            const int32_t index = stack.back();
+            stack.pop_back();
+            const int32_t x = index % size;
+            const int32_t z = (index / size) % size;
+            const int32_t y = index / (size * size);
+
+            // In GDC_ChunkData::SECTION_FACE_* order.
+            const std::array<std::array<int32_t, 3>, GDC_ChunkData::SECTION_FACE_COUNT> steps = { {
+                { x + 1, y, z }, { x - 1, y, z }, { x, y, z + 1 },
+                { x, y, z - 1 }, { x, y + 1, z }, { x, y - 1, z }
+            } };
+            for (int32_t face = 0; face < GDC_ChunkData::SECTION_FACE_COUNT; ++face) {
+                const int32_t nx = steps[face][0];
+                const int32_t ny = steps[face][1];
+                const int32_t nz = steps[face][2];
+                if (nx < 0 || nx >= size || nz < 0 || nz >= size || ny < 0 || ny >= height) {
+                    touched |= 1 << face;
+                    continue;
+                }
+                const int32_t next_index = (ny * size + nz) * size + nx;
+                if (visited[next_index]) { continue; }
+                visited[next_index] = 1;
+                if (!p_blocks.is_opaque(p_cells.get_block(nx, ny, nz))) {
+                    stack.push_back(next_index);
+                }
+            }
+        }
+
+        for (int32_t face = 0; face < GDC_ChunkData::SECTION_FACE_COUNT; ++face) {
+            if (touched & (1 << face)) {
+                r_links[face] |= touched;
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "block_table.h"
+#include "chunk_data.h"
+
+namespace godot {
+
+// One axis-aligned quad covering face `face` of the box [origin, origin + size),
+// in section-local block units.
+struct GDC_MeshQuad {
+    std::array<int32_t, 3> origin;
+    std::array<int32_t, 3> size;
+    int32_t id = 0;
+    int32_t face = 0;
+    int32_t light = 0; // brighter of the sky and block light in front of the face, 0-15
+    // Ambient occlusion per corner, in GDC_VoxelMesher::FACE_CORNERS order:
+    // 0 (tucked into a corner) to 3 (unoccluded).
+    std::array<uint8_t, 4> ao = { 3, 3, 3, 3 };
+
+    // Whether to split the quad along its 1-3 diagonal instead of 0-2: the
+    // diagonal with the brighter corners keeps a single dark corner from
+    // bleeding across the whole quad.
+    bool is_flipped() const { return ao[0] + ao[2] < ao[1] + ao[3]; }
+};
+
+// Face extraction for one section, independent of any vertex format: the
+// meshers turn a GDC_SectionCells into quads, which GDC_ChunkMesher expands into
+// vertices. A face is exposed unless the block table culls it against the cell
+// in front, and only opaque cells darken its corners. Working memory is kept per
+// thread, so once the caller's quad vector has grown, building makes no heap
+// allocations.
+class GDC_VoxelMesher {
+public:
+    // Order shared with the vertex tables in chunk_mesher.cpp and the voxel shader.
+    enum Face {
+        FACE_FRONT = 0, // +z
+        FACE_BACK,      // -z
+        FACE_LEFT,      // -x
+        FACE_RIGHT,     // +x
+        FACE_TOP,       // +y
+        FACE_BOTTOM,    // -y
+        FACE_COUNT
+    };
+
+    static constexpr std::array<std::array<int32_t, 3>, FACE_COUNT> FACE_NORMALS = { {
+        { 0, 0, 1 }, { 0, 0, -1 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }
+    } };
+
+    // Axis along which each face's normal points (0 = x, 1 = y, 2 = z).
+    static constexpr std::array<int32_t, FACE_COUNT> FACE_AXIS = { 2, 2, 0, 0, 1, 1 };
+
+    static constexpr int32_t MAX_AO = 3;
+
+    // Unit-cube corners of each face in vertex order, matching the FACES table
+    // in chunk_mesher.cpp.
+    static constexpr std::array<std::array<std::array<int32_t, 3>, 4>, FACE_COUNT> FACE_CORNERS = { {
+        { { { 0, 0, 1 }, { 0, 1, 1 }, { 1, 1, 1 }, { 1, 0, 1 } } },
+        { { { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 0, 0, 0 } } },
+        { { { 0, 0, 0 }, { 0, 1, 0 }, { 0, 1, 1 }, { 0, 0, 1 } } },
+        { { { 1, 0, 1 }, { 1, 1, 1 }, { 1, 1, 0 }, { 1, 0, 0 } } },
+        { { { 0, 1, 1 }, { 0, 1, 0 }, { 1, 1, 0 }, { 1, 1, 1 } } },
+        { { { 0, 0, 0 }, { 0, 0, 1 }, { 1, 0, 1 }, { 1, 0, 0 } } }
+    } };
+
+    // One quad per exposed cell face.
+    static void build_naive(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks, std::vector<GDC_MeshQuad> &r_quads);
+    // Coplanar exposed faces of the same block, light level and corner AO
+    // merged into rectangles. Faces whose AO changes across them only merge in
+    // the direction it stays constant, so merged quads shade exactly like the
+    // faces they replace. Block ids must fit in 24 bits.
+    static void build_greedy(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks, std::vector<GDC_MeshQuad> &r_quads);
+
+    // Flood-fills each region of air and see-through blocks in the section and
+    // links every pair of faces the region touches. Coarse LOD cells can close
+    // off real openings, so LOD sections are left fully connected.
+    static void compute_face_links(const GDC_SectionCells &p_cells, const GDC_BlockTable &p_blocks, GDC_ChunkData::FaceLinks &r_links);
+};
+
+} // namespace godot
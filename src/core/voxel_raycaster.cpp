@@ -0,0 +1,78 @@
+#include "voxel_raycaster.h"
+
+#include <cmath>
+
+using namespace godot;
+
+static inline int32_t floor_div(int32_t value, int32_t divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+bool GDC_VoxelRaycaster::cast(const std::array<float, 3> &p_from, const std::array<float, 3> &p_dir, float max_dist,
+        ChunkLookup p_lookup, const void *p_userdata, const GDC_BlockTable &p_blocks, GDC_RayHit &r_hit) {
+    const float length = std::sqrt(p_dir[0] * p_dir[0] + p_dir[1] * p_dir[1] + p_dir[2] * p_dir[2]);
+    if (max_dist <= 0.0f || length < 1e-5f) { return false; }
+
+    constexpr int32_t SIZE = GDC_ChunkData::SIZE;
+    std::array<int32_t, 3> block;
+    std::array<int32_t, 3> step;
+    std::array<float, 3> t_delta;
+    std::array<float, 3> t_max;
+    for (int32_t axis = 0; axis < 3; ++axis) {
+        const float dir = p_dir[axis] / length;
+        block[axis] = static_cast<int32_t>(std::floor(p_from[axis]));
+        step[axis] = dir >= 0.0f ? 1 : -1;
+        t_delta[axis] = dir == 0.0f ? 1e30f : std::fabs(1.0f / dir);
+
+        const float offset = p_from[axis] - static_cast<float>(block[axis]);
+        t_max[axis] = step[axis] > 0 ? t_delta[axis] * (1.0f - offset) : t_delta[axis] * offset;
+    }
+
+    int32_t chunk_x = floor_div(block[0], SIZE);
+    int32_t chunk_z = floor_div(block[2], SIZE);
+    std::array<int32_t, 3> local = { block[0] - chunk_x * SIZE, block[1], block[2] - chunk_z * SIZE };
+    const GDC_ChunkData *p_chunk = p_lookup(chunk_x, chunk_z, p_userdata);
+
+    int32_t stepped_axis = -1;
+    float t = 0.0f;
+    while (t <= max_dist) {
+        if (p_chunk != nullptr && stepped_axis != -1) {
+            const int32_t id = p_chunk->get_block(local[0], local[1], local[2]);
+            if (p_blocks.is_solid(id)) {
+                r_hit.block_pos = block;
+                r_hit.normal = { 0, 0, 0 };
+                r_hit.normal[stepped_axis] = -step[stepped_axis];
+                r_hit.block_id = id;
+                return true;
+            }
+        }
+
+        if (t_max[0] < t_max[1]) {
+            stepped_axis = t_max[0] < t_max[2] ? 0 : 2;
+        } else {
+            stepped_axis = t_max[1] < t_max[2] ? 1 : 2;
+        }
+        block[stepped_axis] += step[stepped_axis];
+        local[stepped_axis] += step[stepped_axis];
+        t = t_max[stepped_axis];
+        t_max[stepped_axis] += t_delta[stepped_axis];
+
+        if (stepped_axis == 1 || (local[stepped_axis] >= 0 && local[stepped_axis] < SIZE)) {
+            continue;
+        }
+
+        // Crossed into the next chunk along x or z.
+        const int32_t direction = step[stepped_axis];
+        local[stepped_axis] -= direction * SIZE;
+        int32_t neighbour;
+        if (stepped_axis == 0) {
+            chunk_x += direction;
+            neighbour = direction > 0 ? GDC_ChunkData::NEIGHBOUR_PX : GDC_ChunkData::NEIGHBOUR_NX;
+        } else {
+            chunk_z += direction;
+            neighbour = direction > 0 ? GDC_ChunkData::NEIGHBOUR_PZ : GDC_ChunkData::NEIGHBOUR_NZ;
+        }
+        p_chunk = p_chunk != nullptr ? p_chunk->get_neighbour(neighbour) : p_lookup(chunk_x, chunk_z, p_userdata);
+    }
+    return false;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "block_table.h"
+#include "chunk_data.h"
+
+namespace godot {
+
+struct GDC_RayHit {
+    std::array<int32_t, 3> block_pos = { 0, 0, 0 };
+    std::array<int32_t, 3> normal = { 0, 0, 0 }; // face of the block the ray entered through
+    int32_t block_id = 0;
+};
+
+// Voxel DDA over a grid of GDC_ChunkData columns in world block coordinates,
+// with chunk (x, z) covering blocks [x * SIZE, (x + 1) * SIZE).
+class GDC_VoxelRaycaster {
+public:
+    // Returns the chunk at a chunk coordinate, or nullptr if it is not loaded.
+    using ChunkLookup = const GDC_ChunkData *(*)(int32_t p_chunk_x, int32_t p_chunk_z, const void *p_userdata);
+
+    // The chunk under the ray is kept between steps and followed through its
+    // neighbour links when the ray crosses a chunk border, so `p_lookup` is only
+    // called at the start and when the ray leaves an unloaded area. The ray
+    // stops at the first block `p_blocks` marks solid; blocks in unloaded chunks
+    // and above or below the world count as air. The block the ray starts in is
+    // never reported. Safe to call from several threads while
+    // the chunks are not being edited.
+    static bool cast(const std::array<float, 3> &p_from, const std::array<float, 3> &p_dir, float max_dist,
+            ChunkLookup p_lookup, const void *p_userdata, const GDC_BlockTable &p_blocks, GDC_RayHit &r_hit);
+};
+
+} // namespace godot
@@ -0,0 +1,57 @@
+#include "perf_stats.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace godot;
+
+// A steady clock of our own rather than Time, so worker threads can time their
+// jobs without touching engine singletons.
+uint64_t GDC_PerfStats::get_ticks_usec() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+void GDC_PerfStats::add_mesh(uint64_t p_build_usec, int64_t p_vertices) {
+    ++current.meshes;
+    current.vertices += p_vertices;
+    current.time_usec[TIMER_MESH_BUILD] += p_build_usec;
+
+    const uint32_t sample = static_cast<uint32_t>(std::min<uint64_t>(p_build_usec, UINT32_MAX));
+    if (mesh_samples.size() < MESH_SAMPLE_WINDOW) {
+        mesh_samples.push_back(sample);
+    } else {
+        mesh_samples[next_mesh_sample] = sample;
+    }
+    next_mesh_sample = (next_mesh_sample + 1) % MESH_SAMPLE_WINDOW;
+    mesh_samples_changed = true;
+}
+
+void GDC_PerfStats::add_raycasts(int64_t p_count, uint64_t p_usec) {
+    current.raycasts += p_count;
+    current.time_usec[TIMER_RAYCAST] += p_usec;
+}
+
+void GDC_PerfStats::add_block_ticks(int64_t p_count, uint64_t p_usec) {
+    current.block_ticks += p_count;
+    current.time_usec[TIMER_BLOCK_TICKS] += p_usec;
+}
+
+void GDC_PerfStats::end_frame() {
+    last = current;
+    current = Frame();
+
+    if (!mesh_samples_changed) { return; }
+    mesh_samples_changed = false;
+
+    uint64_t total = 0;
+    for (uint32_t sample : mesh_samples) {
+        total += sample;
+    }
+    mesh_time_mean_ms = total / 1000.0 / mesh_samples.size();
+
+    std::vector<uint32_t> sorted = mesh_samples;
+    const size_t rank = (sorted.size() * 99) / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    mesh_time_p99_ms = sorted[rank] / 1000.0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Per-frame timings and counters of the voxel subsystems. The world owns one,
+// hands it to its chunks, and closes a frame at the end of every _process();
+// the getters report the last closed frame. Only used from the main thread:
+// work timed on worker threads is measured there and added once it is applied.
+class GDC_PerfStats {
+public:
+    enum Timer {
+        TIMER_PROCESS,         // the whole of GDC_World::_process()
+        TIMER_MESH_BUILD,      // GDC_ChunkMesher::build(), summed over sections
+        TIMER_MESH_APPLY,      // uploading buffers into ArrayMeshes
+        TIMER_COLLISION_BUILD, // building section bodies and their box shapes
+        TIMER_COLLISION_FREE,  // clearing bodies of chunks that lost collision
+        TIMER_RAYCAST,         // raycast() and raycast_batch()
+        TIMER_BLOCK_TICKS,     // scheduled and random block ticks, handlers included
+        TIMER_COUNT,
+    };
+
+    // Mean and p99 mesh times are taken over this many of the latest builds, so
+    // they stay meaningful on frames that mesh little or nothing.
+    static const int32_t MESH_SAMPLE_WINDOW = 512;
+
+    static uint64_t get_ticks_usec();
+
+    void add_time(Timer p_timer, uint64_t p_usec) { current.time_usec[p_timer] += p_usec; }
+    void add_mesh(uint64_t p_build_usec, int64_t p_vertices);
+    void add_raycasts(int64_t p_count, uint64_t p_usec);
+    void add_block_ticks(int64_t p_count, uint64_t p_usec);
+
+    void end_frame();
+
+    int32_t get_meshes_built() const { return last.meshes; }
+    int64_t get_vertices_emitted() const { return last.vertices; }
+    int64_t get_raycasts() const { return last.raycasts; }
+    int64_t get_block_ticks() const { return last.block_ticks; }
+    double get_time_ms(Timer p_timer) const { return last.time_usec[p_timer] / 1000.0; }
+    double get_mesh_time_mean_ms() const { return mesh_time_mean_ms; }
+    double get_mesh_time_p99_ms() const { return mesh_time_p99_ms; }
+
+private:
+    struct Frame {
+        int32_t meshes = 0;
+        int64_t vertices = 0;
+        int64_t raycasts = 0;
+        int64_t block_ticks = 0;
+        std::array<uint64_t, TIMER_COUNT> time_usec = {};
+    };
+
+    Frame current;
+    Frame last;
+
+    std::vector<uint32_t> mesh_samples; // ring buffer of build times in usec
+    size_t next_mesh_sample = 0;
+    bool mesh_samples_changed = false;
+    double mesh_time_mean_ms = 0.0;
+    double mesh_time_p99_ms = 0.0;
+};
+
+// Adds the time between construction and destruction to a timer; does nothing
+// without stats.
+class GDC_PerfScope {
+public:
+    GDC_PerfScope(GDC_PerfStats *p_stats, GDC_PerfStats::Timer p_timer) :
+            p_stats(p_stats), timer(p_timer), start(p_stats != nullptr ? GDC_PerfStats::get_ticks_usec() : 0) {}
+    ~GDC_PerfScope() {
+        if (p_stats != nullptr) {
+            p_stats->add_time(timer, GDC_PerfStats::get_ticks_usec() - start);
+        }
+    }
+
+    GDC_PerfScope(const GDC_PerfScope &) = delete;
+    GDC_PerfScope &operator=(const GDC_PerfScope &) = delete;
+
+private:
+    GDC_PerfStats *p_stats;
+    GDC_PerfStats::Timer timer;
+    uint64_t start;
+};
+
+} // namespace godot
@@ -0,0 +1,347 @@
+#include "region_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include "chunk.h"
+#include "core/chunk_codec.h"
+
+using namespace godot;
+
+static const char REGION_MAGIC[4] = { 'G', 'D', 'C', 'R' };
+static const uint32_t REGION_VERSION = 1;
+
+// Column record header: uncompressed size (u32) followed by the compression mode (u8).
+static const size_t RECORD_HEADER_SIZE = 5;
+static const uint8_t RECORD_ZSTD = 1;
+
+// The header and records are written in host byte order, which is little-endian
+// on every platform the extension is built for.
+
+GDC_RegionFile::GDC_RegionFile(const std::string &p_path) :
+        path(p_path) {
+    p_file = std::fopen(path.c_str(), "r+b");
+    if (p_file != nullptr) {
+        if (!read_header()) {
+            // Not a region file (or a newer version); leave it untouched.
+            std::fclose(p_file);
+            p_file = nullptr;
+        }
+        return;
+    }
+
+    p_file = std::fopen(path.c_str(), "w+b");
+    if (p_file != nullptr && !write_header()) {
+        std::fclose(p_file);
+        p_file = nullptr;
+    }
+}
+
+GDC_RegionFile::~GDC_RegionFile() {
+    unmap_file();
+    if (p_file != nullptr) {
+        std::fclose(p_file);
+    }
+}
+
+bool GDC_RegionFile::has_column(int32_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries[index].sector != 0;
+}
+
+bool GDC_RegionFile::read_column(int32_t index, std::vector<uint8_t> &r_data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Entry entry = entries[index];
+    if (p_file == nullptr || entry.sector == 0) { return false; }
+
+    const size_t begin = static_cast<size_t>(entry.sector) * SECTOR_SIZE;
+    const size_t end = begin + entry.length;
+    if (p_mapped == nullptr || end > mapped_size) {
+        unmap_file();
+        if (!map_file()) { return false; }
+    }
+    if (end > mapped_size) { return false; }
+
+    r_data.assign(p_mapped + begin, p_mapped + end);
+    return true;
+}
+
+bool GDC_RegionFile::write_column(int32_t index, const uint8_t *p_data, uint32_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (p_file == nullptr) { return false; }
+
+    Entry &entry = entries[index];
+    const uint32_t sectors_needed = (size + SECTOR_SIZE - 1) / SECTOR_SIZE;
+    const uint32_t sectors_used = (entry.length + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+    uint32_t sector = entry.sector;
+    if (sector == 0 || sectors_needed > sectors_used) {
+        // Append; the old sectors (if any) are left unused.
+        sector = sector_count;
+        sector_count += sectors_needed;
+        // Growing a file under a live mapping is not portable, so the mapping
+        // is dropped here and recreated by the next read.
+        unmap_file();
+    }
+
+    if (std::fseek(p_file, static_cast<long>(sector) * SECTOR_SIZE, SEEK_SET) != 0) { return false; }
+    if (std::fwrite(p_data, 1, size, p_file) != size) { return false; }
+
+    // Pad to the sector boundary so the file length always matches sector_count.
+    static const uint8_t zeros[SECTOR_SIZE] = {};
+    const uint32_t padding = sectors_needed * SECTOR_SIZE - size;
+    if (padding > 0 && std::fwrite(zeros, 1, padding, p_file) != padding) { return false; }
+
+    entry.sector = sector;
+    entry.length = size;
+    if (std::fseek(p_file, static_cast<long>(8 + index * sizeof(Entry)), SEEK_SET) != 0) { return false; }
+    if (std::fwrite(&entry, sizeof(Entry), 1, p_file) != 1) { return false; }
+
+    return std::fflush(p_file) == 0;
+}
+
+bool GDC_RegionFile::read_header() {
+    char magic[4];
+    uint32_t version = 0;
+    if (std::fread(magic, 1, 4, p_file) != 4 || std::memcmp(magic, REGION_MAGIC, 4) != 0) { return false; }
+    if (std::fread(&version, sizeof(version), 1, p_file) != 1 || version != REGION_VERSION) { return false; }
+    if (std::fread(entries.data(), sizeof(Entry), COLUMN_COUNT, p_file) != COLUMN_COUNT) { return false; }
+
+    sector_count = HEADER_SECTORS;
+    for (const Entry &entry : entries) {
+        if (entry.sector != 0) {
+            sector_count = std::max(sector_count, entry.sector + (entry.length + SECTOR_SIZE - 1) / SECTOR_SIZE);
+        }
+    }
+    return true;
+}
+
+bool GDC_RegionFile::write_header() {
+    entries.fill(Entry());
+    sector_count = HEADER_SECTORS;
+
+    std::vector<uint8_t> header(HEADER_SECTORS * SECTOR_SIZE, 0);
+    std::memcpy(header.data(), REGION_MAGIC, 4);
+    std::memcpy(header.data() + 4, &REGION_VERSION, sizeof(REGION_VERSION));
+
+    if (std::fwrite(header.data(), 1, header.size(), p_file) != header.size()) { return false; }
+    return std::fflush(p_file) == 0;
+}
+
+#ifdef _WIN32
+
+bool GDC_RegionFile::map_file() {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void *p_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (p_view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle = file;
+    mapping_handle = mapping;
+    p_mapped = static_cast<const uint8_t *>(p_view);
+    mapped_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void GDC_RegionFile::unmap_file() {
+    if (p_mapped != nullptr) {
+        UnmapViewOfFile(p_mapped);
+        CloseHandle(static_cast<HANDLE>(mapping_handle));
+        CloseHandle(static_cast<HANDLE>(file_handle));
+    }
+    p_mapped = nullptr;
+    mapped_size = 0;
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+}
+
+#else
+
+bool GDC_RegionFile::map_file() {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *p_view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    if (p_view == MAP_FAILED) { return false; }
+
+    p_mapped = static_cast<const uint8_t *>(p_view);
+    mapped_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void GDC_RegionFile::unmap_file() {
+    if (p_mapped != nullptr) {
+        munmap(const_cast<uint8_t *>(p_mapped), mapped_size);
+    }
+    p_mapped = nullptr;
+    mapped_size = 0;
+}
+
+#endif
+
+GDC_RegionStore::GDC_RegionStore(const std::string &p_directory) :
+        directory(p_directory) {
+}
+
+GDC_RegionStore::~GDC_RegionStore() {
+    for (const KeyValue<Vector2i, GDC_RegionFile *> &E : regions) {
+        memdelete(E.value);
+    }
+}
+
+bool GDC_RegionStore::has_chunk(Vector2i coord) {
+    GDC_RegionFile *p_region = get_region(get_region_coord(coord));
+    return p_region != nullptr && p_region->has_column(get_column_index(coord));
+}
+
+bool GDC_RegionStore::load_chunk(Vector2i coord, int32_t *r_ids) {
+    GDC_RegionFile *p_region = get_region(get_region_coord(coord));
+    if (p_region == nullptr) { return false; }
+
+    std::vector<uint8_t> record;
+    if (!p_region->read_column(get_column_index(coord), record)) { return false; }
+    if (record.size() < RECORD_HEADER_SIZE || record[4] != RECORD_ZSTD) { return false; }
+
+    uint32_t raw_size = 0;
+    std::memcpy(&raw_size, record.data(), sizeof(raw_size));
+
+    PackedByteArray compressed;
+    compressed.resize(static_cast<int64_t>(record.size() - RECORD_HEADER_SIZE));
+    std::memcpy(compressed.ptrw(), record.data() + RECORD_HEADER_SIZE, record.size() - RECORD_HEADER_SIZE);
+
+    const PackedByteArray raw = compressed.decompress(raw_size, FileAccess::COMPRESSION_ZSTD);
+    if (raw.size() != static_cast<int64_t>(raw_size)) { return false; }
+
+    return decode_blocks(raw.ptr(), raw_size, r_ids, GDC_Chunk::BLOCK_COUNT);
+}
+
+bool GDC_RegionStore::save_chunk(Vector2i coord, const int32_t *p_ids) {
+    GDC_RegionFile *p_region = get_region(get_region_coord(coord));
+    if (p_region == nullptr) { return false; }
+
+    thread_local std::vector<uint8_t> encoded;
+    encode_blocks(p_ids, GDC_Chunk::BLOCK_COUNT, encoded);
+
+    PackedByteArray raw;
+    raw.resize(static_cast<int64_t>(encoded.size()));
+    std::memcpy(raw.ptrw(), encoded.data(), encoded.size());
+    const PackedByteArray compressed = raw.compress(FileAccess::COMPRESSION_ZSTD);
+
+    std::vector<uint8_t> record(RECORD_HEADER_SIZE + compressed.size());
+    const uint32_t raw_size = static_cast<uint32_t>(encoded.size());
+    std::memcpy(record.data(), &raw_size, sizeof(raw_size));
+    record[4] = RECORD_ZSTD;
+    std::memcpy(record.data() + RECORD_HEADER_SIZE, compressed.ptr(), compressed.size());
+
+    return p_region->write_column(get_column_index(coord), record.data(), static_cast<uint32_t>(record.size()));
+}
+
+void GDC_RegionStore::encode_blocks(const int32_t *p_ids, int32_t count, std::vector<uint8_t> &r_out) {
+    r_out.clear();
+    int32_t i = 0;
+    while (i < count) {
+        const int32_t id = p_ids[i];
+        int32_t run = 1;
+        while (i + run < count && p_ids[i + run] == id) {
+            ++run;
+        }
+        GDC_ChunkCodec::write_varint(r_out, static_cast<uint32_t>(id));
+        GDC_ChunkCodec::write_varint(r_out, static_cast<uint32_t>(run));
+        i += run;
+    }
+}
+
+bool GDC_RegionStore::decode_blocks(const uint8_t *p_data, size_t size, int32_t *r_ids, int32_t count) {
+    size_t pos = 0;
+    int32_t filled = 0;
+    while (pos < size) {
+        uint32_t id = 0;
+        uint32_t run = 0;
+        if (!GDC_ChunkCodec::read_varint(p_data, size, pos, id) || !GDC_ChunkCodec::read_varint(p_data, size, pos, run)) { return false; }
+        if (run > static_cast<uint32_t>(count - filled)) { return false; }
+
+        std::fill(r_ids + filled, r_ids + filled + run, static_cast<int32_t>(id));
+        filled += static_cast<int32_t>(run);
+    }
+    return filled == count;
+}
+
+GDC_RegionFile *GDC_RegionStore::get_region(Vector2i region_coord) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (GDC_RegionFile **p_found = regions.getptr(region_coord)) {
+        return *p_found;
+    }
+
+    const std::string path = directory + "/r." + std::to_string(region_coord.x) + "." + std::to_string(region_coord.y) + ".gdcr";
+    GDC_RegionFile *p_region = memnew(GDC_RegionFile(path));
+    if (!p_region->is_open()) {
+        // Not cached, so a later call retries (e.g. once the directory exists).
+        memdelete(p_region);
+        return nullptr;
+    }
+    regions.insert(region_coord, p_region);
+    return p_region;
+}
+
+static int32_t floor_div(int32_t value, int32_t divisor) {
+    return value < 0 ? (value + 1) / divisor - 1 : value / divisor;
+}
+
+Vector2i GDC_RegionStore::get_region_coord(Vector2i coord) {
+    return Vector2i(
+            floor_div(coord.x, GDC_RegionFile::REGION_SIZE),
+            floor_div(coord.y, GDC_RegionFile::REGION_SIZE));
+}
+
+int32_t GDC_RegionStore::get_column_index(Vector2i coord) {
+    const Vector2i region = get_region_coord(coord);
+    const int32_t local_x = coord.x - region.x * GDC_RegionFile::REGION_SIZE;
+    const int32_t local_z = coord.y - region.y * GDC_RegionFile::REGION_SIZE;
+    return local_x + local_z * GDC_RegionFile::REGION_SIZE;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+namespace godot {
+
+// One region file holding up to REGION_SIZE x REGION_SIZE chunk columns.
+//
+// Layout: a header sector area with a magic, a version and an offset table of
+// (first sector, byte length) per column, followed by the column records, each
+// starting on a SECTOR_SIZE boundary. A rewritten record stays in place if it
+// still fits its sectors and is appended to the end of the file otherwise.
+//
+// Reads go through a read-only memory mapping of the file that is refreshed
+// when the file has grown; writes go through stdio. All methods are thread-safe.
+class GDC_RegionFile {
+public:
+    static constexpr int32_t REGION_SIZE = 32;
+    static constexpr int32_t COLUMN_COUNT = REGION_SIZE * REGION_SIZE;
+    static constexpr uint32_t SECTOR_SIZE = 4096;
+
+    explicit GDC_RegionFile(const std::string &p_path);
+    ~GDC_RegionFile();
+
+    bool is_open() const { return p_file != nullptr; }
+
+    // `index` is local_x + local_z * REGION_SIZE.
+    bool has_column(int32_t index);
+    bool read_column(int32_t index, std::vector<uint8_t> &r_data);
+    bool write_column(int32_t index, const uint8_t *p_data, uint32_t size);
+
+private:
+    struct Entry {
+        uint32_t sector = 0; // 0 means the column is not stored
+        uint32_t length = 0;
+    };
+
+    static constexpr uint32_t HEADER_SECTORS = (8 + COLUMN_COUNT * sizeof(Entry) + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+    bool read_header();
+    bool write_header();
+    bool map_file();
+    void unmap_file();
+
+    std::mutex mutex;
+    std::string path;
+    std::FILE *p_file = nullptr;
+    std::array<Entry, COLUMN_COUNT> entries;
+    uint32_t sector_count = HEADER_SECTORS;
+
+    const uint8_t *p_mapped = nullptr;
+    size_t mapped_size = 0;
+#ifdef _WIN32
+    void *mapping_handle = nullptr;
+    void *file_handle = nullptr;
+#endif
+};
+
+// Chunk column persistence on top of a directory of region files.
+//
+// A column is stored as run-length encoded block ids (varint id, varint run
+// length, in the chunk's y, z, x order) which are then zstd-compressed. Region
+// files are opened on first use and kept open. Thread-safe.
+class GDC_RegionStore {
+public:
+    explicit GDC_RegionStore(const std::string &p_directory);
+    ~GDC_RegionStore();
+
+    const std::string &get_directory() const { return directory; }
+
+    bool has_chunk(Vector2i coord);
+
+    // Both take GDC_Chunk::BLOCK_COUNT ids.
+    bool load_chunk(Vector2i coord, int32_t *r_ids);
+    bool save_chunk(Vector2i coord, const int32_t *p_ids);
+
+    static void encode_blocks(const int32_t *p_ids, int32_t count, std::vector<uint8_t> &r_out);
+    static bool decode_blocks(const uint8_t *p_data, size_t size, int32_t *r_ids, int32_t count);
+
+private:
+    GDC_RegionFile *get_region(Vector2i region_coord);
+
+    static Vector2i get_region_coord(Vector2i coord);
+    static int32_t get_column_index(Vector2i coord);
+
+    std::mutex mutex;
+    std::string directory;
+    HashMap<Vector2i, GDC_RegionFile *> regions;
+};
+
+} // namespace godot
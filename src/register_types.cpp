@@ -5,6 +5,7 @@
 #include "block_set.h"
 #include "chunk.h"
 #include "hit_payload.h"
+#include "terrain_generator.h"
 #include "world.h"
 
 #include <gdextension_interface.h>
@@ -24,6 +25,7 @@ void initialize_gdcraft_module(ModuleInitializationLevel p_level) {
 	GDREGISTER_CLASS(GDC_Chunk);
 	GDREGISTER_CLASS(GDC_HitPayload);
 	GDREGISTER_CLASS(GDC_World);
+	GDREGISTER_CLASS(GDC_TerrainGenerator);
 }
 
 void uninitialize_gdcraft_module(ModuleInitializationLevel p_level) {
@@ -0,0 +1,222 @@
+#include "terrain_generator.h"
+
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include "block_registry.h"
+#include "world.h"
+
+using namespace godot;
+
+void GDC_TerrainGenerator::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_seed"), &GDC_TerrainGenerator::get_seed);
+    ClassDB::bind_method(D_METHOD("set_seed", "seed"), &GDC_TerrainGenerator::set_seed);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+
+    ADD_GROUP("Height", "");
+    ClassDB::bind_method(D_METHOD("get_base_height"), &GDC_TerrainGenerator::get_base_height);
+    ClassDB::bind_method(D_METHOD("set_base_height", "height"), &GDC_TerrainGenerator::set_base_height);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "base_height", PROPERTY_HINT_RANGE, "1,127"), "set_base_height", "get_base_height");
+
+    ClassDB::bind_method(D_METHOD("get_height_amplitude"), &GDC_TerrainGenerator::get_height_amplitude);
+    ClassDB::bind_method(D_METHOD("set_height_amplitude", "amplitude"), &GDC_TerrainGenerator::set_height_amplitude);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "height_amplitude"), "set_height_amplitude", "get_height_amplitude");
+
+    ClassDB::bind_method(D_METHOD("get_height_frequency"), &GDC_TerrainGenerator::get_height_frequency);
+    ClassDB::bind_method(D_METHOD("set_height_frequency", "frequency"), &GDC_TerrainGenerator::set_height_frequency);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "height_frequency"), "set_height_frequency", "get_height_frequency");
+
+    ClassDB::bind_method(D_METHOD("get_height_octaves"), &GDC_TerrainGenerator::get_height_octaves);
+    ClassDB::bind_method(D_METHOD("set_height_octaves", "octaves"), &GDC_TerrainGenerator::set_height_octaves);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "height_octaves", PROPERTY_HINT_RANGE, "1,8"), "set_height_octaves", "get_height_octaves");
+
+    ClassDB::bind_method(D_METHOD("get_height_gain"), &GDC_TerrainGenerator::get_height_gain);
+    ClassDB::bind_method(D_METHOD("set_height_gain", "gain"), &GDC_TerrainGenerator::set_height_gain);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "height_gain"), "set_height_gain", "get_height_gain");
+
+    ClassDB::bind_method(D_METHOD("get_dirt_depth"), &GDC_TerrainGenerator::get_dirt_depth);
+    ClassDB::bind_method(D_METHOD("set_dirt_depth", "depth"), &GDC_TerrainGenerator::set_dirt_depth);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "dirt_depth"), "set_dirt_depth", "get_dirt_depth");
+
+    ADD_GROUP("Caves", "");
+    ClassDB::bind_method(D_METHOD("get_caves_enabled"), &GDC_TerrainGenerator::get_caves_enabled);
+    ClassDB::bind_method(D_METHOD("set_caves_enabled", "enabled"), &GDC_TerrainGenerator::set_caves_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "caves_enabled"), "set_caves_enabled", "get_caves_enabled");
+
+    ClassDB::bind_method(D_METHOD("get_cave_frequency"), &GDC_TerrainGenerator::get_cave_frequency);
+    ClassDB::bind_method(D_METHOD("set_cave_frequency", "frequency"), &GDC_TerrainGenerator::set_cave_frequency);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cave_frequency"), "set_cave_frequency", "get_cave_frequency");
+
+    ClassDB::bind_method(D_METHOD("get_cave_threshold"), &GDC_TerrainGenerator::get_cave_threshold);
+    ClassDB::bind_method(D_METHOD("set_cave_threshold", "threshold"), &GDC_TerrainGenerator::set_cave_threshold);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cave_threshold", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_cave_threshold", "get_cave_threshold");
+
+    ADD_GROUP("Blocks", "");
+    ClassDB::bind_method(D_METHOD("get_stone_block"), &GDC_TerrainGenerator::get_stone_block);
+    ClassDB::bind_method(D_METHOD("set_stone_block", "name"), &GDC_TerrainGenerator::set_stone_block);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "stone_block"), "set_stone_block", "get_stone_block");
+
+    ClassDB::bind_method(D_METHOD("get_dirt_block"), &GDC_TerrainGenerator::get_dirt_block);
+    ClassDB::bind_method(D_METHOD("set_dirt_block", "name"), &GDC_TerrainGenerator::set_dirt_block);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "dirt_block"), "set_dirt_block", "get_dirt_block");
+
+    ClassDB::bind_method(D_METHOD("get_grass_block"), &GDC_TerrainGenerator::get_grass_block);
+    ClassDB::bind_method(D_METHOD("set_grass_block", "name"), &GDC_TerrainGenerator::set_grass_block);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "grass_block"), "set_grass_block", "get_grass_block");
+
+    ClassDB::bind_method(D_METHOD("generate_chunk", "chunk", "coord"), &GDC_TerrainGenerator::generate_chunk);
+    ClassDB::bind_method(D_METHOD("generate_area", "world", "from", "to"), &GDC_TerrainGenerator::generate_area);
+}
+
+int32_t GDC_TerrainGenerator::get_seed() const { return seed; }
+void GDC_TerrainGenerator::set_seed(int32_t p_seed) { seed = p_seed; }
+
+int32_t GDC_TerrainGenerator::get_base_height() const { return base_height; }
+void GDC_TerrainGenerator::set_base_height(int32_t p_height) { base_height = p_height; }
+
+float GDC_TerrainGenerator::get_height_amplitude() const { return height_amplitude; }
+void GDC_TerrainGenerator::set_height_amplitude(float p_amplitude) { height_amplitude = p_amplitude; }
+
+float GDC_TerrainGenerator::get_height_frequency() const { return height_frequency; }
+void GDC_TerrainGenerator::set_height_frequency(float p_frequency) { height_frequency = p_frequency; }
+
+int32_t GDC_TerrainGenerator::get_height_octaves() const { return height_octaves; }
+void GDC_TerrainGenerator::set_height_octaves(int32_t p_octaves) { height_octaves = p_octaves; }
+
+float GDC_TerrainGenerator::get_height_gain() const { return height_gain; }
+void GDC_TerrainGenerator::set_height_gain(float p_gain) { height_gain = p_gain; }
+
+int32_t GDC_TerrainGenerator::get_dirt_depth() const { return dirt_depth; }
+void GDC_TerrainGenerator::set_dirt_depth(int32_t p_depth) { dirt_depth = p_depth; }
+
+bool GDC_TerrainGenerator::get_caves_enabled() const { return caves_enabled; }
+void GDC_TerrainGenerator::set_caves_enabled(bool p_enabled) { caves_enabled = p_enabled; }
+
+float GDC_TerrainGenerator::get_cave_frequency() const { return cave_frequency; }
+void GDC_TerrainGenerator::set_cave_frequency(float p_frequency) { cave_frequency = p_frequency; }
+
+float GDC_TerrainGenerator::get_cave_threshold() const { return cave_threshold; }
+void GDC_TerrainGenerator::set_cave_threshold(float p_threshold) { cave_threshold = p_threshold; }
+
+String GDC_TerrainGenerator::get_stone_block() const { return stone_block; }
+void GDC_TerrainGenerator::set_stone_block(const String &p_name) { stone_block = p_name; }
+
+String GDC_TerrainGenerator::get_dirt_block() const { return dirt_block; }
+void GDC_TerrainGenerator::set_dirt_block(const String &p_name) { dirt_block = p_name; }
+
+String GDC_TerrainGenerator::get_grass_block() const { return grass_block; }
+void GDC_TerrainGenerator::set_grass_block(const String &p_name) { grass_block = p_name; }
+
+void GDC_TerrainGenerator::generate_chunk(GDC_Chunk *p_chunk, Vector2i coord) const {
+    ERR_FAIL_NULL(p_chunk);
+
+    Layers layers;
+    if (!resolve_layers(layers)) { return; }
+
+    std::vector<int32_t> ids(GDC_Chunk::BLOCK_COUNT);
+    generate_column(layers, coord, ids.data());
+    p_chunk->load_block_data(ids.data(), GDC_Chunk::get_block_table());
+}
+
+// Generates, registers and queues meshes for every missing chunk with
+// from <= coord < to. Returns the number of chunks created.
+int32_t GDC_TerrainGenerator::generate_area(GDC_World *p_world, Vector2i from, Vector2i to) const {
+    ERR_FAIL_NULL_V(p_world, 0);
+
+    Layers layers;
+    if (!resolve_layers(layers)) { return 0; }
+
+    std::vector<GDC_Chunk *> chunks;
+    std::vector<Vector2i> coords;
+    for (int32_t z = from.y; z < to.y; ++z) {
+        for (int32_t x = from.x; x < to.x; ++x) {
+            const Vector2i coord(x, z);
+            if (p_world->get_chunk(coord) != nullptr) { continue; }
+            chunks.push_back(p_world->acquire_chunk());
+            coords.push_back(coord);
+        }
+    }
+
+    generate_chunks(layers, chunks, coords);
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        p_world->register_chunk(chunks[i], coords[i]);
+    }
+    for (const Vector2i &coord : coords) {
+        p_world->queue_chunk_mesh(coord);
+    }
+    return static_cast<int32_t>(chunks.size());
+}
+
+bool GDC_TerrainGenerator::resolve_layers(Layers &r_layers) const {
+    GDC_BlockRegistry *reg = GDC_BlockRegistry::get_singleton();
+    ERR_FAIL_NULL_V_MSG(reg, false, "GDC_TerrainGenerator: no GDC_BlockRegistry in the scene tree.");
+
+    const Ref<GDC_BlockData> stone = reg->get_block_by_name(stone_block);
+    const Ref<GDC_BlockData> dirt = reg->get_block_by_name(dirt_block);
+    const Ref<GDC_BlockData> grass = reg->get_block_by_name(grass_block);
+    ERR_FAIL_COND_V_MSG(stone.is_null() || dirt.is_null() || grass.is_null(), false,
+            "GDC_TerrainGenerator: stone/dirt/grass blocks are missing in GDC_BlockRegistry.");
+
+    r_layers.stone = stone->get_id();
+    r_layers.dirt = dirt->get_id();
+    r_layers.grass = grass->get_id();
+    return true;
+}
+
+namespace {
+
+struct GenerateBatch {
+    const GDC_TerrainGenerator *p_generator = nullptr;
+    GDC_TerrainGenerator::Layers layers;
+    GDC_BlockTable blocks;
+    const std::vector<GDC_Chunk *> *p_chunks = nullptr;
+    const std::vector<Vector2i> *p_coords = nullptr;
+};
+
+void generate_batch_task(void *p_userdata, uint32_t p_index) {
+    const GenerateBatch *p_batch = static_cast<const GenerateBatch *>(p_userdata);
+
+    thread_local std::vector<int32_t> ids;
+    ids.resize(GDC_Chunk::BLOCK_COUNT);
+
+    p_batch->p_generator->generate_column(p_batch->layers, (*p_batch->p_coords)[p_index], ids.data());
+    (*p_batch->p_chunks)[p_index]->load_block_data(ids.data(), p_batch->blocks);
+}
+
+} // namespace
+
+void GDC_TerrainGenerator::generate_chunks(const Layers &p_layers, const std::vector<GDC_Chunk *> &p_chunks, const std::vector<Vector2i> &p_coords) const {
+    ERR_FAIL_COND(p_chunks.size() != p_coords.size());
+    if (p_chunks.empty()) { return; }
+
+    GenerateBatch batch;
+    batch.p_generator = this;
+    batch.layers = p_layers;
+    batch.blocks = GDC_Chunk::get_block_table();
+    batch.p_chunks = &p_chunks;
+    batch.p_coords = &p_coords;
+
+    WorkerThreadPool *p_pool = WorkerThreadPool::get_singleton();
+    const WorkerThreadPool::GroupID group = p_pool->add_native_group_task(
+            &generate_batch_task, &batch, static_cast<int>(p_chunks.size()), -1, true, "GDC_TerrainGenerator");
+    p_pool->wait_for_group_task_completion(group);
+}
+
+void GDC_TerrainGenerator::generate_column(const Layers &p_layers, Vector2i coord, int32_t *r_ids) const {
+    GDC_TerrainColumn column;
+    column.seed = seed;
+    column.base_height = base_height;
+    column.height_amplitude = height_amplitude;
+    column.height_frequency = height_frequency;
+    column.height_octaves = height_octaves;
+    column.height_gain = height_gain;
+    column.dirt_depth = dirt_depth;
+    column.caves_enabled = caves_enabled;
+    column.cave_frequency = cave_frequency;
+    column.cave_threshold = cave_threshold;
+    column.stone = p_layers.stone;
+    column.dirt = p_layers.dirt;
+    column.grass = p_layers.grass;
+    column.generate(coord.x, coord.y, r_ids);
+}
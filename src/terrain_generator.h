@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include "chunk.h"
+#include "core/terrain_column.h"
+
+namespace godot {
+
+class GDC_World;
+
+// Seeded heightmap + 3D-noise terrain: layered stone/dirt/grass columns with
+// noise caves carved out of them. Output depends only on the settings and the
+// chunk coordinate, so chunks can be generated in any order on any thread.
+class GDC_TerrainGenerator : public Resource {
+    GDCLASS(GDC_TerrainGenerator, Resource)
+
+public:
+    // Block ids resolved from the registry on the main thread before generating.
+    struct Layers {
+        int32_t stone = 0;
+        int32_t dirt = 0;
+        int32_t grass = 0;
+    };
+
+private:
+    int32_t seed = 1337;
+
+    int32_t base_height = 32;
+    float height_amplitude = 16.0f;
+    float height_frequency = 0.01f;
+    int32_t height_octaves = 4;
+    float height_gain = 0.5f;
+    int32_t dirt_depth = 3;
+
+    bool caves_enabled = true;
+    float cave_frequency = 0.06f;
+    float cave_threshold = 0.45f;
+
+    String stone_block = "stone";
+    String dirt_block = "dirt";
+    String grass_block = "grass";
+
+protected:
+    static void _bind_methods();
+
+public:
+    GDC_TerrainGenerator() = default;
+    ~GDC_TerrainGenerator() override = default;
+
+    int32_t get_seed() const;
+    void set_seed(int32_t p_seed);
+    int32_t get_base_height() const;
+    void set_base_height(int32_t p_height);
+    float get_height_amplitude() const;
+    void set_height_amplitude(float p_amplitude);
+    float get_height_frequency() const;
+    void set_height_frequency(float p_frequency);
+    int32_t get_height_octaves() const;
+    void set_height_octaves(int32_t p_octaves);
+    float get_height_gain() const;
+    void set_height_gain(float p_gain);
+    int32_t get_dirt_depth() const;
+    void set_dirt_depth(int32_t p_depth);
+
+    bool get_caves_enabled() const;
+    void set_caves_enabled(bool p_enabled);
+    float get_cave_frequency() const;
+    void set_cave_frequency(float p_frequency);
+    float get_cave_threshold() const;
+    void set_cave_threshold(float p_threshold);
+
+    String get_stone_block() const;
+    void set_stone_block(const String &p_name);
+    String get_dirt_block() const;
+    void set_dirt_block(const String &p_name);
+    String get_grass_block() const;
+    void set_grass_block(const String &p_name);
+
+    void generate_chunk(GDC_Chunk *p_chunk, Vector2i coord) const;
+    int32_t generate_area(GDC_World *p_world, Vector2i from, Vector2i to) const;
+
+    bool resolve_layers(Layers &r_layers) const;
+
+    // Fills each chunk with the terrain for the matching coordinate, one chunk
+    // per WorkerThreadPool task. The chunks must not be registered in a world
+    // yet, since filling them is not synchronised with anything else.
+    void generate_chunks(const Layers &p_layers, const std::vector<GDC_Chunk *> &p_chunks, const std::vector<Vector2i> &p_coords) const;
+
+    // Writes one column's BLOCK_COUNT ids in the chunk's native y, z, x order.
+    // Thread-safe as long as the settings are not modified concurrently.
+    void generate_column(const Layers &p_layers, Vector2i coord, int32_t *r_ids) const;
+};
+
+} // namespace godot
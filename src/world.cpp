@@ -1,18 +1,380 @@
 #include "world.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <vector>
 
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/classes/world3d.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
+#include "block_registry.h"
+#include "core/chunk_codec.h"
+
 namespace godot {
 
 void GDC_World::_bind_methods() {
     ClassDB::bind_method(D_METHOD("register_chunk", "chunk", "coord"), &GDC_World::register_chunk);
+    ClassDB::bind_method(D_METHOD("unregister_chunk", "coord"), &GDC_World::unregister_chunk);
+    ClassDB::bind_method(D_METHOD("unload_chunk", "coord"), &GDC_World::unload_chunk);
     ClassDB::bind_method(D_METHOD("get_chunk", "coord"), &GDC_World::get_chunk);
     ClassDB::bind_method(D_METHOD("get_chunk_at", "world_pos"), &GDC_World::get_chunk_at);
+    ClassDB::bind_method(D_METHOD("acquire_chunk"), &GDC_World::acquire_chunk);
+    ClassDB::bind_method(D_METHOD("release_chunk", "chunk"), &GDC_World::release_chunk);
     ClassDB::bind_method(D_METHOD("get_block_at", "world_pos"), &GDC_World::get_block_at);
     ClassDB::bind_method(D_METHOD("set_block_at", "world_pos", "id"), &GDC_World::set_block_at);
+    ClassDB::bind_method(D_METHOD("begin_edit"), &GDC_World::begin_edit);
+    ClassDB::bind_method(D_METHOD("commit_edit"), &GDC_World::commit_edit);
+    ClassDB::bind_method(D_METHOD("set_blocks", "positions", "ids"), &GDC_World::set_blocks);
+    ClassDB::bind_method(D_METHOD("get_region", "from", "to"), &GDC_World::get_region);
+    ClassDB::bind_method(D_METHOD("set_region", "from", "to", "ids"), &GDC_World::set_region);
+    ClassDB::bind_method(D_METHOD("take_edit_deltas"), &GDC_World::take_edit_deltas);
+    ClassDB::bind_method(D_METHOD("apply_edit_deltas", "deltas"), &GDC_World::apply_edit_deltas);
+    ClassDB::bind_method(D_METHOD("schedule_tick", "position", "delay"), &GDC_World::schedule_tick);
+    ClassDB::bind_method(D_METHOD("is_tick_scheduled", "position"), &GDC_World::is_tick_scheduled);
+    ClassDB::bind_method(D_METHOD("run_tick"), &GDC_World::run_tick);
+    ClassDB::bind_method(D_METHOD("get_game_tick"), &GDC_World::get_game_tick);
+    ClassDB::bind_method(D_METHOD("get_scheduled_tick_count"), &GDC_World::get_scheduled_tick_count);
     ClassDB::bind_method(D_METHOD("raycast", "from", "dir", "max_dist"), &GDC_World::raycast);
+    ClassDB::bind_method(D_METHOD("raycast_batch", "origins", "dirs", "max_dist"), &GDC_World::raycast_batch);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), "RAYCAST_STRIDE", RAYCAST_STRIDE);
+
+    ClassDB::bind_method(D_METHOD("get_chunk_count"), &GDC_World::get_chunk_count);
+    ClassDB::bind_method(D_METHOD("get_block_storage_bytes"), &GDC_World::get_block_storage_bytes);
+
+    ClassDB::bind_method(D_METHOD("queue_chunk_mesh", "coord"), &GDC_World::queue_chunk_mesh);
+    ClassDB::bind_method(D_METHOD("wait_for_chunk_mesh", "coord"), &GDC_World::wait_for_chunk_mesh);
+    ClassDB::bind_method(D_METHOD("wait_for_all_meshes"), &GDC_World::wait_for_all_meshes);
+    ClassDB::bind_method(D_METHOD("get_pending_mesh_jobs"), &GDC_World::get_pending_mesh_jobs);
+
+    ClassDB::bind_method(D_METHOD("get_meshing_mode"), &GDC_World::get_meshing_mode);
+    ClassDB::bind_method(D_METHOD("set_meshing_mode", "mode"), &GDC_World::set_meshing_mode);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "meshing_mode", PROPERTY_HINT_ENUM, "Naive,Greedy"), "set_meshing_mode", "get_meshing_mode");
+
+    ClassDB::bind_method(D_METHOD("get_vertex_format"), &GDC_World::get_vertex_format);
+    ClassDB::bind_method(D_METHOD("set_vertex_format", "format"), &GDC_World::set_vertex_format);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "vertex_format", PROPERTY_HINT_ENUM, "Standard,Compact"), "set_vertex_format", "get_vertex_format");
+
+    ClassDB::bind_method(D_METHOD("get_mesh_bytes"), &GDC_World::get_mesh_bytes);
+
+    ADD_GROUP("Streaming", "");
+    ClassDB::bind_method(D_METHOD("is_streaming_enabled"), &GDC_World::is_streaming_enabled);
+    ClassDB::bind_method(D_METHOD("set_streaming_enabled", "enabled"), &GDC_World::set_streaming_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "streaming_enabled"), "set_streaming_enabled", "is_streaming_enabled");
+
+    ClassDB::bind_method(D_METHOD("get_viewer"), &GDC_World::get_viewer);
+    ClassDB::bind_method(D_METHOD("set_viewer", "viewer"), &GDC_World::set_viewer);
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "viewer", PROPERTY_HINT_NODE_TYPE, "Node3D"), "set_viewer", "get_viewer");
+
+    ClassDB::bind_method(D_METHOD("get_load_radius"), &GDC_World::get_load_radius);
+    ClassDB::bind_method(D_METHOD("set_load_radius", "radius"), &GDC_World::set_load_radius);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "load_radius", PROPERTY_HINT_RANGE, "1,64"), "set_load_radius", "get_load_radius");
+
+    ClassDB::bind_method(D_METHOD("get_unload_radius"), &GDC_World::get_unload_radius);
+    ClassDB::bind_method(D_METHOD("set_unload_radius", "radius"), &GDC_World::set_unload_radius);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "unload_radius", PROPERTY_HINT_RANGE, "2,66"), "set_unload_radius", "get_unload_radius");
+
+    ClassDB::bind_method(D_METHOD("get_max_loads_per_frame"), &GDC_World::get_max_loads_per_frame);
+    ClassDB::bind_method(D_METHOD("set_max_loads_per_frame", "count"), &GDC_World::set_max_loads_per_frame);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_loads_per_frame", PROPERTY_HINT_RANGE, "1,64"), "set_max_loads_per_frame", "get_max_loads_per_frame");
+
+    ClassDB::bind_method(D_METHOD("get_terrain_generator"), &GDC_World::get_terrain_generator);
+    ClassDB::bind_method(D_METHOD("set_terrain_generator", "generator"), &GDC_World::set_terrain_generator);
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "terrain_generator", PROPERTY_HINT_RESOURCE_TYPE, "GDC_TerrainGenerator"), "set_terrain_generator", "get_terrain_generator");
+
+    ClassDB::bind_method(D_METHOD("get_pending_generate_jobs"), &GDC_World::get_pending_generate_jobs);
+
+    ClassDB::bind_method(D_METHOD("get_chunk_pool_size"), &GDC_World::get_chunk_pool_size);
+    ClassDB::bind_method(D_METHOD("set_chunk_pool_size", "size"), &GDC_World::set_chunk_pool_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_pool_size", PROPERTY_HINT_RANGE, "0,1024"), "set_chunk_pool_size", "get_chunk_pool_size");
+
+    ClassDB::bind_method(D_METHOD("get_pooled_chunk_count"), &GDC_World::get_pooled_chunk_count);
+    ClassDB::bind_method(D_METHOD("get_chunk_pool_hits"), &GDC_World::get_chunk_pool_hits);
+    ClassDB::bind_method(D_METHOD("get_chunk_pool_misses"), &GDC_World::get_chunk_pool_misses);
+
+    ADD_GROUP("Collision", "");
+    ClassDB::bind_method(D_METHOD("get_collision_radius"), &GDC_World::get_collision_radius);
+    ClassDB::bind_method(D_METHOD("set_collision_radius", "radius"), &GDC_World::set_collision_radius);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_radius", PROPERTY_HINT_RANGE, "0,16"), "set_collision_radius", "get_collision_radius");
+
+    ClassDB::bind_method(D_METHOD("get_collision_chunk_count"), &GDC_World::get_collision_chunk_count);
+
+    ADD_GROUP("Level of Detail", "");
+    ClassDB::bind_method(D_METHOD("get_lod_distance"), &GDC_World::get_lod_distance);
+    ClassDB::bind_method(D_METHOD("set_lod_distance", "distance"), &GDC_World::set_lod_distance);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_distance", PROPERTY_HINT_RANGE, "0,32,0.5"), "set_lod_distance", "get_lod_distance");
+
+    ClassDB::bind_method(D_METHOD("get_max_lod"), &GDC_World::get_max_lod);
+    ClassDB::bind_method(D_METHOD("set_max_lod", "lod"), &GDC_World::set_max_lod);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_lod", PROPERTY_HINT_RANGE, "0,3"), "set_max_lod", "get_max_lod");
+
+    ADD_GROUP("Culling", "");
+    ClassDB::bind_method(D_METHOD("is_cave_culling_enabled"), &GDC_World::is_cave_culling_enabled);
+    ClassDB::bind_method(D_METHOD("set_cave_culling_enabled", "enabled"), &GDC_World::set_cave_culling_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cave_culling_enabled"), "set_cave_culling_enabled", "is_cave_culling_enabled");
+
+    ClassDB::bind_method(D_METHOD("get_visible_chunk_count"), &GDC_World::get_visible_chunk_count);
+    ClassDB::bind_method(D_METHOD("get_visible_section_count"), &GDC_World::get_visible_section_count);
+
+    ADD_GROUP("Ticks", "");
+    ClassDB::bind_method(D_METHOD("get_ticks_per_second"), &GDC_World::get_ticks_per_second);
+    ClassDB::bind_method(D_METHOD("set_ticks_per_second", "rate"), &GDC_World::set_ticks_per_second);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "ticks_per_second", PROPERTY_HINT_RANGE, "0,100,1"), "set_ticks_per_second", "get_ticks_per_second");
+
+    ClassDB::bind_method(D_METHOD("get_random_tick_speed"), &GDC_World::get_random_tick_speed);
+    ClassDB::bind_method(D_METHOD("set_random_tick_speed", "speed"), &GDC_World::set_random_tick_speed);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "random_tick_speed", PROPERTY_HINT_RANGE, "0,64"), "set_random_tick_speed", "get_random_tick_speed");
+
+    ADD_GROUP("Replication", "");
+    ClassDB::bind_method(D_METHOD("is_edit_recording_enabled"), &GDC_World::is_edit_recording_enabled);
+    ClassDB::bind_method(D_METHOD("set_edit_recording_enabled", "enabled"), &GDC_World::set_edit_recording_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "edit_recording_enabled"), "set_edit_recording_enabled", "is_edit_recording_enabled");
+
+    ADD_GROUP("Saving", "");
+    ClassDB::bind_method(D_METHOD("get_save_path"), &GDC_World::get_save_path);
+    ClassDB::bind_method(D_METHOD("set_save_path", "path"), &GDC_World::set_save_path);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "save_path"), "set_save_path", "get_save_path");
+
+    ClassDB::bind_method(D_METHOD("save_chunk", "coord"), &GDC_World::save_chunk);
+    ClassDB::bind_method(D_METHOD("save_world"), &GDC_World::save_world);
+    ClassDB::bind_method(D_METHOD("get_pending_save_jobs"), &GDC_World::get_pending_save_jobs);
+
+    ADD_GROUP("Profiling", "");
+    ClassDB::bind_method(D_METHOD("get_trace_path"), &GDC_World::get_trace_path);
+    ClassDB::bind_method(D_METHOD("set_trace_path", "path"), &GDC_World::set_trace_path);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "trace_path", PROPERTY_HINT_SAVE_FILE, "*.csv"), "set_trace_path", "get_trace_path");
+
+    ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &GDC_World::get_monitor);
+    ClassDB::bind_static_method(get_class_static(), D_METHOD("get_monitor_name", "monitor"), &GDC_World::get_monitor_name);
+
+    BIND_ENUM_CONSTANT(MONITOR_PROCESS_TIME);
+    BIND_ENUM_CONSTANT(MONITOR_MESHES_BUILT);
+    BIND_ENUM_CONSTANT(MONITOR_MESH_TIME_MEAN);
+    BIND_ENUM_CONSTANT(MONITOR_MESH_TIME_P99);
+    BIND_ENUM_CONSTANT(MONITOR_MESH_APPLY_TIME);
+    BIND_ENUM_CONSTANT(MONITOR_VERTICES_EMITTED);
+    BIND_ENUM_CONSTANT(MONITOR_COLLISION_BUILD_TIME);
+    BIND_ENUM_CONSTANT(MONITOR_COLLISION_FREE_TIME);
+    BIND_ENUM_CONSTANT(MONITOR_RAYCASTS);
+    BIND_ENUM_CONSTANT(MONITOR_RAYCAST_TIME);
+    BIND_ENUM_CONSTANT(MONITOR_LOADED_CHUNKS);
+    BIND_ENUM_CONSTANT(MONITOR_BLOCK_STORAGE_BYTES);
+    BIND_ENUM_CONSTANT(MONITOR_MESH_BYTES);
+    BIND_ENUM_CONSTANT(MONITOR_PENDING_MESH_JOBS);
+    BIND_ENUM_CONSTANT(MONITOR_PENDING_GENERATE_JOBS);
+    BIND_ENUM_CONSTANT(MONITOR_PENDING_SAVE_JOBS);
+    BIND_ENUM_CONSTANT(MONITOR_CHUNK_POOL_HITS);
+    BIND_ENUM_CONSTANT(MONITOR_CHUNK_POOL_MISSES);
+    BIND_ENUM_CONSTANT(MONITOR_POOLED_CHUNKS);
+    BIND_ENUM_CONSTANT(MONITOR_BLOCK_TICKS);
+    BIND_ENUM_CONSTANT(MONITOR_BLOCK_TICK_TIME);
+    BIND_ENUM_CONSTANT(MONITOR_SCHEDULED_TICKS);
+}
+
+// Chunk-coordinate offset of each GDC_Chunk::NEIGHBOUR_* index. Opposite
+// neighbours differ only in the lowest bit (PX <-> NX, PZ <-> NZ).
+static const Vector2i NEIGHBOUR_OFFSETS[4] = {
+    Vector2i(1, 0), Vector2i(-1, 0), Vector2i(0, 1), Vector2i(0, -1)
+};
+
+// The chunks diagonally across each corner, whose AO reads that corner column.
+static const Vector2i DIAGONAL_OFFSETS[4] = {
+    Vector2i(1, 1), Vector2i(1, -1), Vector2i(-1, 1), Vector2i(-1, -1)
+};
+
+// Chunks whose direction from the viewer is more than ~30 degrees away from the
+// direction the load queue was sorted for get re-sorted.
+static const float VIEW_RESORT_DOT = 0.866f;
+
+// How much further a chunk directly behind the viewer counts as, compared to
+// one straight ahead at the same distance.
+static const float VIEW_PRIORITY_WEIGHT = 1.0f;
+
+// Rays per raycast_batch() work item; small enough to spread a few thousand
+// rays over every worker, large enough to keep the per-item overhead low.
+static const int32_t RAYCAST_GROUP_SIZE = 64;
+
+// Custom monitor ids, in GDC_World::Monitor order; also the trace file columns.
+static const char *MONITOR_NAMES[GDC_World::MONITOR_COUNT] = {
+    "gdcraft/process_ms",
+    "gdcraft/meshes_built",
+    "gdcraft/mesh_time_mean_ms",
+    "gdcraft/mesh_time_p99_ms",
+    "gdcraft/mesh_apply_ms",
+    "gdcraft/vertices_emitted",
+    "gdcraft/collision_build_ms",
+    "gdcraft/collision_free_ms",
+    "gdcraft/raycasts",
+    "gdcraft/raycast_ms",
+    "gdcraft/loaded_chunks",
+    "gdcraft/block_storage_bytes",
+    "gdcraft/mesh_bytes",
+    "gdcraft/pending_mesh_jobs",
+    "gdcraft/pending_generate_jobs",
+    "gdcraft/pending_save_jobs",
+    "gdcraft/chunk_pool_hits",
+    "gdcraft/chunk_pool_misses",
+    "gdcraft/pooled_chunks",
+    "gdcraft/block_ticks",
+    "gdcraft/block_tick_ms",
+    "gdcraft/scheduled_ticks",
+};
+
+// A chunk only changes LOD once it is this far (in LOD steps) past the boundary,
+// so a viewer standing on the boundary does not remesh it every frame.
+static const float LOD_HYSTERESIS = 0.1f;
+
+// A frame runs at most this many game ticks; a world further behind than that
+// drops the rest rather than spending ever longer frames catching up.
+static const int32_t MAX_TICKS_PER_FRAME = 4;
+
+// splitmix64: random ticks only need cheap, evenly spread positions.
+static uint64_t next_random_tick(uint64_t &r_state) {
+    uint64_t z = (r_state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// The chunk and the native y, z, x index of a block position; false above or
+// below the world.
+static bool get_tick_key(Vector3i position, Vector2i &r_coord, int32_t &r_index) {
+    if (position.y < 0 || position.y >= GDC_Chunk::HEIGHT) { return false; }
+    const Vector3 world_pos(position.x, position.y, position.z);
+    r_coord = GDC_World::world_pos_to_chunk_coord(world_pos);
+    const Vector3i local = GDC_World::world_to_local(world_pos);
+    r_index = (local.y * GDC_Chunk::SIZE + local.z) * GDC_Chunk::SIZE + local.x;
+    return true;
+}
+
+GDC_World::~GDC_World() {
+    // Workers only touch their own job, so it is enough to let them finish
+    // before the jobs are freed; results are discarded.
+    for (const KeyValue<Vector2i, MeshJob *> &E : mesh_jobs) {
+        WorkerThreadPool::get_singleton()->wait_for_task_completion(E.value->task_id);
+        memdelete(E.value);
+    }
+    mesh_jobs.clear();
+    for (MeshJob *p_job : idle_mesh_jobs) {
+        memdelete(p_job);
+    }
+    idle_mesh_jobs.clear();
+
+    for (const KeyValue<Vector2i, GenerateJob *> &E : generate_jobs) {
+        WorkerThreadPool::get_singleton()->wait_for_task_completion(E.value->task_id);
+        memdelete(E.value->p_chunk);
+        memdelete(E.value);
+    }
+    generate_jobs.clear();
+
+    // Chunks are not nodes, so nothing else frees them.
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        memdelete(E.value);
+    }
+    p_chunks.clear();
+    for (GDC_Chunk *p_chunk : chunk_pool) {
+        memdelete(p_chunk);
+    }
+    chunk_pool.clear();
+
+    close_region_store();
+    close_trace();
+}
+
+void GDC_World::_process(double p_delta) {
+    {
+        GDC_PerfScope scope(&perf_stats, GDC_PerfStats::TIMER_PROCESS);
+
+        poll_save_jobs();
+        poll_generate_jobs();
+        if (streaming_enabled && !Engine::get_singleton()->is_editor_hint()) {
+            update_streaming();
+        }
+        if (!Engine::get_singleton()->is_editor_hint()) {
+            update_ticks(p_delta);
+        }
+
+        update_lods();
+
+        if (edit_depth == 0) {
+            flush_dirty_chunks();
+        }
+        update_collision();
+
+        std::vector<MeshJob *> completed;
+        for (const KeyValue<Vector2i, MeshJob *> &E : mesh_jobs) {
+            if (WorkerThreadPool::get_singleton()->is_task_completed(E.value->task_id)) {
+                completed.push_back(E.value);
+            }
+        }
+        for (MeshJob *p_job : completed) {
+            finish_mesh_job(p_job);
+        }
+
+        update_visibility();
+    }
+
+    perf_stats.end_frame();
+    write_trace_frame();
+}
+
+void GDC_World::_enter_tree() {
+    set_notify_transform(true);
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        place_chunk(E.value, E.key);
+    }
+
+    if (!Engine::get_singleton()->is_editor_hint()) {
+        register_monitors();
+        open_trace();
+    }
+}
+
+void GDC_World::_exit_tree() {
+    if (!Engine::get_singleton()->is_editor_hint()) {
+        save_world();
+    }
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        E.value->set_world(RID(), RID());
+    }
+    unregister_monitors();
+    close_trace();
+}
+
+// Chunks live on the servers rather than below the world in the tree, so the
+// world forwards its own transform and visibility to them.
+void GDC_World::_notification(int p_what) {
+    if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+        for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+            E.value->set_transform(get_chunk_transform(E.key));
+        }
+    } else if (p_what == NOTIFICATION_VISIBILITY_CHANGED) {
+        const bool chunks_visible = is_visible_in_tree();
+        for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+            E.value->set_visible(chunks_visible);
+        }
+    }
+}
+
+Transform3D GDC_World::get_chunk_transform(Vector2i coord) const {
+    const Vector3 origin(coord.x * GDC_Chunk::SIZE, 0, coord.y * GDC_Chunk::SIZE);
+    return get_global_transform() * Transform3D(Basis(), origin);
+}
+
+// Puts the chunk's instances and bodies into this world's scenario and space.
+void GDC_World::place_chunk(GDC_Chunk *p_chunk, Vector2i coord) {
+    const Ref<World3D> world_3d = get_world_3d();
+    if (world_3d.is_null()) { return; }
+
+    p_chunk->set_transform(get_chunk_transform(coord));
+    p_chunk->set_visible(is_visible_in_tree());
+    p_chunk->set_world(world_3d->get_scenario(), world_3d->get_space());
 }
 
 void GDC_World::register_chunk(GDC_Chunk *p_chunk, Vector2i coord) {
@@ -20,10 +382,13 @@ void GDC_World::register_chunk(GDC_Chunk *p_chunk, Vector2i coord) {
     if (p_chunks.has(coord)) { return; }
 
     p_chunks[coord] = p_chunk;
-    add_child(p_chunk);
-    p_chunk->set_position(Vector3(
-        coord.x * GDC_Chunk::SIZE, 0, coord.y * GDC_Chunk::SIZE
-    ));
+    p_chunk->set_perf_stats(&perf_stats);
+    p_chunk->set_meshing_mode(meshing_mode);
+    p_chunk->set_vertex_format(vertex_format);
+    p_chunk->set_edit_tracking_enabled(edit_recording_enabled);
+    if (is_inside_tree()) {
+        place_chunk(p_chunk, coord);
+    }
 
     GDC_Chunk *p_px = get_chunk(coord + Vector2i(1, 0));
     GDC_Chunk *p_nx = get_chunk(coord + Vector2i(-1, 0));
@@ -39,6 +404,78 @@ void GDC_World::register_chunk(GDC_Chunk *p_chunk, Vector2i coord) {
     if (p_nx) p_nx->set_neighbour(GDC_Chunk::NEIGHBOUR_PX, p_chunk);
     if (p_pz) p_pz->set_neighbour(GDC_Chunk::NEIGHBOUR_NZ, p_chunk);
     if (p_nz) p_nz->set_neighbour(GDC_Chunk::NEIGHBOUR_PZ, p_chunk);
+
+    // Light crosses the new borders both ways; neighbours whose light changed
+    // are picked up by flush_dirty_chunks().
+    p_chunk->stitch_light();
+
+    // The new chunk hides faces its neighbours used to expose along the border,
+    // and shades the AO of the diagonal chunks' corner columns.
+    mark_chunk_dirty(coord);
+    for (int32_t i = 0; i < 4; ++i) {
+        if (GDC_Chunk *p_neighbour = p_chunk->get_neighbour(i)) {
+            p_neighbour->mark_all_sections_dirty();
+            mark_chunk_dirty(coord + NEIGHBOUR_OFFSETS[i]);
+        }
+        if (GDC_Chunk *p_diagonal = get_chunk(coord + DIAGONAL_OFFSETS[i])) {
+            p_diagonal->mark_all_sections_dirty();
+            mark_chunk_dirty(coord + DIAGONAL_OFFSETS[i]);
+        }
+    }
+}
+
+// Removes the chunk from the world and unlinks it from its neighbours in both
+// directions. The caller takes ownership of the returned chunk.
+GDC_Chunk *GDC_World::unregister_chunk(Vector2i coord) {
+    GDC_Chunk **p_found = p_chunks.getptr(coord);
+    if (p_found == nullptr) { return nullptr; }
+
+    GDC_Chunk *p_chunk = *p_found;
+    p_chunks.erase(coord);
+    dirty_chunks.erase(coord);
+    tick_scheduler.clear_chunk(coord.x, coord.y);
+    if (collision_chunks.has(coord)) {
+        p_chunk->set_collision_enabled(false);
+        collision_chunks.erase(coord);
+    }
+
+    // A running job only reads its own snapshot; forget the chunk so the
+    // result is dropped instead of applied.
+    if (MeshJob **p_job = mesh_jobs.getptr(coord)) {
+        (*p_job)->p_chunk = nullptr;
+    }
+
+    for (int32_t i = 0; i < 4; ++i) {
+        GDC_Chunk *p_neighbour = p_chunk->get_neighbour(i);
+        if (p_neighbour == nullptr) { continue; }
+
+        p_neighbour->set_neighbour(i ^ 1, nullptr);
+        p_chunk->set_neighbour(i, nullptr);
+
+        // The border faces facing the removed chunk are exposed again.
+        p_neighbour->mark_all_sections_dirty();
+        mark_chunk_dirty(coord + NEIGHBOUR_OFFSETS[i]);
+    }
+    // The diagonal chunks' corner columns read as air again.
+    for (int32_t i = 0; i < 4; ++i) {
+        if (GDC_Chunk *p_diagonal = get_chunk(coord + DIAGONAL_OFFSETS[i])) {
+            p_diagonal->mark_all_sections_dirty();
+            mark_chunk_dirty(coord + DIAGONAL_OFFSETS[i]);
+        }
+    }
+
+    p_chunk->set_perf_stats(nullptr);
+    p_chunk->set_world(RID(), RID());
+    return p_chunk;
+}
+
+void GDC_World::unload_chunk(Vector2i coord) {
+    if (GDC_Chunk *p_chunk = unregister_chunk(coord)) {
+        if (p_region_store != nullptr && p_chunk->is_modified()) {
+            start_save_job(coord, p_chunk);
+        }
+        release_chunk(p_chunk);
+    }
 }
 
 GDC_Chunk *GDC_World::get_chunk(Vector2i coord) {
@@ -50,6 +487,52 @@ GDC_Chunk *GDC_World::get_chunk_at(Vector3 world_pos) {
 	return get_chunk(world_pos_to_chunk_coord(world_pos));
 }
 
+GDC_Chunk *GDC_World::acquire_chunk() {
+    if (chunk_pool.empty()) {
+        ++chunk_pool_misses;
+        return memnew(GDC_Chunk);
+    }
+    ++chunk_pool_hits;
+    GDC_Chunk *p_chunk = chunk_pool.back();
+    chunk_pool.pop_back();
+    return p_chunk;
+}
+
+// The chunk must not be registered; a full pool frees it instead.
+void GDC_World::release_chunk(GDC_Chunk *p_chunk) {
+    ERR_FAIL_NULL(p_chunk);
+    if (static_cast<int32_t>(chunk_pool.size()) >= chunk_pool_size) {
+        memdelete(p_chunk);
+        return;
+    }
+    p_chunk->reset();
+    chunk_pool.push_back(p_chunk);
+}
+
+int32_t GDC_World::get_chunk_pool_size() const {
+    return chunk_pool_size;
+}
+
+void GDC_World::set_chunk_pool_size(int32_t p_size) {
+    chunk_pool_size = MAX(p_size, 0);
+    while (static_cast<int32_t>(chunk_pool.size()) > chunk_pool_size) {
+        memdelete(chunk_pool.back());
+        chunk_pool.pop_back();
+    }
+}
+
+int32_t GDC_World::get_pooled_chunk_count() const {
+    return static_cast<int32_t>(chunk_pool.size());
+}
+
+int64_t GDC_World::get_chunk_pool_hits() const {
+    return chunk_pool_hits;
+}
+
+int64_t GDC_World::get_chunk_pool_misses() const {
+    return chunk_pool_misses;
+}
+
 int32_t GDC_World::get_block_at(Vector3 world_pos) {
 	GDC_Chunk *p_chunk = get_chunk_at(world_pos);
     if (!p_chunk) { return -1; }
@@ -64,82 +547,1227 @@ void GDC_World::set_block_at(Vector3 world_pos, int32_t id) {
 
     Vector3i local = world_to_local(world_pos);
     p_chunk->set_block(local.x, local.y, local.z, id);
-    p_chunk->generate_mesh();
 
-    Vector2i chunk_coord = world_pos_to_chunk_coord(world_pos);
-    if (local.x == 0) {
-        GDC_Chunk *p_neighbour = get_chunk(chunk_coord + Vector2i(-1, 0));
-        if (p_neighbour) { p_neighbour->generate_mesh(); }
+    mark_border_chunks_dirty(world_pos_to_chunk_coord(world_pos), local.x == 0, local.x == GDC_Chunk::SIZE - 1,
+            local.z == 0, local.z == GDC_Chunk::SIZE - 1);
+}
+
+void GDC_World::begin_edit() {
+    ++edit_depth;
+}
+
+void GDC_World::commit_edit() {
+    if (edit_depth == 0) { return; }
+    if (--edit_depth == 0) {
+        flush_dirty_chunks();
     }
-    if (local.x == GDC_Chunk::SIZE - 1) {
-        GDC_Chunk *p_neighbour = get_chunk(chunk_coord + Vector2i(1, 0));
-        if (p_neighbour) { p_neighbour->generate_mesh(); }
+}
+
+void GDC_World::set_blocks(const PackedVector3iArray &positions, const PackedInt32Array &ids) {
+    ERR_FAIL_COND_MSG(positions.size() != ids.size(), "set_blocks: positions and ids must have the same size.");
+
+    begin_edit();
+    const Vector3i *p_positions = positions.ptr();
+    const int32_t *p_ids = ids.ptr();
+    for (int64_t i = 0; i < positions.size(); ++i) {
+        set_block_at(Vector3(p_positions[i].x, p_positions[i].y, p_positions[i].z), p_ids[i]);
     }
-    if (local.z == 0) {
-        GDC_Chunk *p_neighbour = get_chunk(chunk_coord + Vector2i(0, -1));
-        if (p_neighbour) { p_neighbour->generate_mesh(); }
+    commit_edit();
+}
+
+PackedInt32Array GDC_World::get_region(Vector3i from, Vector3i to) const {
+    PackedInt32Array ids;
+    const Vector3i size = to - from;
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) { return ids; }
+    const int64_t volume = int64_t(size.x) * size.y * size.z;
+    ERR_FAIL_COND_V_MSG(volume > INT32_MAX, ids, "get_region: the region is too large.");
+
+    ids.resize(volume);
+    int32_t *p_ids = ids.ptrw();
+    std::fill_n(p_ids, volume, -1);
+
+    thread_local std::vector<RegionBox> boxes;
+    get_region_boxes(from, to, boxes);
+    for (const RegionBox &box : boxes) {
+        box.p_chunk->get_box(box.from, box.to, p_ids + box.offset, size.x, size.x * size.z);
     }
-    if (local.z == GDC_Chunk::SIZE - 1) {
-        GDC_Chunk *p_neighbour = get_chunk(chunk_coord + Vector2i(0, 1));
-        if (p_neighbour) { p_neighbour->generate_mesh(); }
+    return ids;
+}
+
+void GDC_World::set_region(Vector3i from, Vector3i to, const PackedInt32Array &ids) {
+    const Vector3i size = to - from;
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) { return; }
+    ERR_FAIL_COND_MSG(ids.size() != int64_t(size.x) * size.y * size.z, "set_region: ids must hold one id per block in the region.");
+
+    thread_local std::vector<RegionBox> boxes;
+    thread_local std::vector<GDC_Chunk *> changed;
+    get_region_boxes(from, to, boxes);
+    changed.clear();
+
+    begin_edit();
+    const int32_t *p_ids = ids.ptr();
+    for (const RegionBox &box : boxes) {
+        if (!box.p_chunk->set_box(box.from, box.to, p_ids + box.offset, size.x, size.x * size.z, false)) { continue; }
+        changed.push_back(box.p_chunk);
+
+        // Faces along the borders the box touches belong to the neighbours too.
+        mark_border_chunks_dirty(box.coord, box.from.x == 0, box.to.x == GDC_Chunk::SIZE, box.from.z == 0,
+                box.to.z == GDC_Chunk::SIZE);
     }
+    // One relight of the union of the changed chunks' areas, instead of one
+    // 3x3 relight per chunk.
+    GDC_Chunk::relight_areas(changed);
+    commit_edit();
 }
 
-Variant GDC_World::raycast(Vector3 from, Vector3 dir, float max_dist) {
-    if (max_dist <= 0.0f || dir.is_zero_approx()) { return Variant(); }
-    dir = dir.normalized();
-
-	float dx = dir.x;
-    float dy = dir.y;
-    float dz = dir.z;
-
-    int ix = int(floorf(from.x));
-    int iy = int(floorf(from.y));
-    int iz = int(floorf(from.z));
-
-    int step_x = dx >= 0.0f ? 1 : -1;
-    int step_y = dy >= 0.0f ? 1 : -1;
-    int step_z = dz >= 0.0f ? 1 : -1;
-
-    float tx_delta = dx == 0.0f ? 1e30f : fabsf(1.0f / dx);
-    float ty_delta = dy == 0.0f ? 1e30f : fabsf(1.0f / dy);
-    float tz_delta = dz == 0.0f ? 1e30f : fabsf(1.0f / dz);
-
-    float tx_max = step_x > 0 ? tx_delta * (1.0f - fmodf(from.x - (float)ix, 1.0f)) : tx_delta * fmodf(from.x - ix, 1.0f);
-    float ty_max = step_y > 0 ? ty_delta * (1.0f - fmodf(from.y - (float)iy, 1.0f)) : ty_delta * fmodf(from.y - iy, 1.0f);
-    float tz_max = step_z > 0 ? tz_delta * (1.0f - fmodf(from.z - (float)iz, 1.0f)) : tz_delta * fmodf(from.z - iz, 1.0f);
-
-    int stepped_index = -1;
-    float t = 0.0f;
-    while (t <= max_dist) {
-        int32_t block = get_block_at(Vector3(ix, iy, iz));
-        if (block > 0 && stepped_index != -1) {
-            Vector3i norm(0, 0, 0);
-            if (stepped_index == 0) norm.x = -step_x;
-            else if (stepped_index == 1) norm.y = -step_y;
-            else if (stepped_index == 2) norm.z = -step_z;
-            Ref<GDC_HitPayload> payload;
-            payload.instantiate();
-            payload->set_block_pos(Vector3i(ix, iy, iz));
-            payload->set_normal(norm);
-            payload->set_block_id(block);
-            return payload;
-        }
-        if (tx_max < ty_max) {
-            if (tx_max < tz_max) {
-                ix += step_x; t = tx_max; tx_max += tx_delta; stepped_index = 0;
+void GDC_World::get_region_boxes(Vector3i from, Vector3i to, std::vector<RegionBox> &r_boxes) const {
+    r_boxes.clear();
+    const int32_t from_y = std::max(from.y, 0);
+    const int32_t to_y = std::min(to.y, GDC_Chunk::HEIGHT);
+    if (from_y >= to_y) { return; }
+
+    const Vector3i size = to - from;
+    const Vector2i first = world_pos_to_chunk_coord(Vector3(from.x, 0, from.z));
+    const Vector2i last = world_pos_to_chunk_coord(Vector3(to.x - 1, 0, to.z - 1));
+    for (int32_t cz = first.y; cz <= last.y; ++cz) {
+        for (int32_t cx = first.x; cx <= last.x; ++cx) {
+            GDC_Chunk *const *p_found = p_chunks.getptr(Vector2i(cx, cz));
+            if (!p_found) { continue; }
+
+            const Vector3i origin(cx * GDC_Chunk::SIZE, 0, cz * GDC_Chunk::SIZE);
+            RegionBox box;
+            box.p_chunk = *p_found;
+            box.coord = Vector2i(cx, cz);
+            box.from = Vector3i(std::max(from.x - origin.x, 0), from_y, std::max(from.z - origin.z, 0));
+            box.to = Vector3i(std::min(to.x - origin.x, GDC_Chunk::SIZE), to_y, std::min(to.z - origin.z, GDC_Chunk::SIZE));
+            box.offset = (int64_t(from_y - from.y) * size.z + (origin.z + box.from.z - from.z)) * size.x + (origin.x + box.from.x - from.x);
+            r_boxes.push_back(box);
+        }
+    }
+}
+
+bool GDC_World::is_edit_recording_enabled() const {
+    return edit_recording_enabled;
+}
+
+void GDC_World::set_edit_recording_enabled(bool p_enabled) {
+    edit_recording_enabled = p_enabled;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        E.value->set_edit_tracking_enabled(p_enabled);
+    }
+}
+
+static uint32_t zigzag_encode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+PackedByteArray GDC_World::take_edit_deltas() {
+    thread_local std::vector<uint8_t> bytes;
+    thread_local std::vector<uint8_t> delta;
+    bytes.clear();
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        if (!E.value->has_edits()) { continue; }
+        E.value->take_delta(delta);
+        GDC_ChunkCodec::write_varint(bytes, zigzag_encode(E.key.x));
+        GDC_ChunkCodec::write_varint(bytes, zigzag_encode(E.key.y));
+        GDC_ChunkCodec::write_varint(bytes, static_cast<uint32_t>(delta.size()));
+        bytes.insert(bytes.end(), delta.begin(), delta.end());
+    }
+
+    PackedByteArray deltas;
+    deltas.resize(static_cast<int64_t>(bytes.size()));
+    std::copy(bytes.begin(), bytes.end(), deltas.ptrw());
+    return deltas;
+}
+
+int32_t GDC_World::apply_edit_deltas(const PackedByteArray &deltas) {
+    const uint8_t *p_data = deltas.ptr();
+    const size_t size = static_cast<size_t>(deltas.size());
+    int32_t applied = 0;
+
+    begin_edit();
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t x = 0;
+        uint32_t z = 0;
+        uint32_t length = 0;
+        if (!GDC_ChunkCodec::read_varint(p_data, size, pos, x) || !GDC_ChunkCodec::read_varint(p_data, size, pos, z) ||
+                !GDC_ChunkCodec::read_varint(p_data, size, pos, length) || length > size - pos) {
+            ERR_PRINT("apply_edit_deltas: malformed delta buffer.");
+            break;
+        }
+
+        const Vector2i coord(zigzag_decode(x), zigzag_decode(z));
+        GDC_Chunk *p_chunk = get_chunk(coord);
+        if (p_chunk != nullptr) {
+            if (p_chunk->apply_delta(p_data + pos, length)) {
+                // Border blocks dirty the neighbours' sections too, diagonal
+                // ones included; the others are left out when their jobs find
+                // nothing dirty.
+                mark_border_chunks_dirty(coord, true, true, true, true);
+                ++applied;
             } else {
-                iz += step_z; t = tz_max; tz_max += tz_delta; stepped_index = 2;
+                ERR_PRINT("apply_edit_deltas: malformed delta for chunk " + String(coord) + ".");
             }
-        } else {
-            if (ty_max < tz_max) {
-                iy += step_y; t = ty_max; ty_max += ty_delta; stepped_index = 1;
-            } else {
-                iz += step_z; t = tz_max; tz_max += tz_delta; stepped_index = 2;
+        }
+        pos += length;
+    }
+    commit_edit();
+    return applied;
+}
+
+bool GDC_World::schedule_tick(Vector3i position, int32_t delay) {
+    Vector2i coord;
+    int32_t index = 0;
+    if (!get_tick_key(position, coord, index) || !p_chunks.has(coord)) { return false; }
+    return tick_scheduler.schedule(coord.x, coord.y, index, game_tick + MAX(delay, 1));
+}
+
+bool GDC_World::is_tick_scheduled(Vector3i position) const {
+    Vector2i coord;
+    int32_t index = 0;
+    if (!get_tick_key(position, coord, index)) { return false; }
+    return tick_scheduler.is_scheduled(coord.x, coord.y, index);
+}
+
+// Collects every tick first, so handlers can edit, schedule, load and unload
+// freely; each block is read again right before its handler runs.
+void GDC_World::run_tick() {
+    ERR_FAIL_COND_MSG(ticking, "run_tick: called from a tick handler.");
+    const uint64_t start = GDC_PerfStats::get_ticks_usec();
+    ticking = true;
+    ++game_tick;
+
+    due_ticks.clear();
+    block_ticks.clear();
+    tick_scheduler.pop_due(game_tick, due_ticks);
+    for (const GDC_TickScheduler::Tick &tick : due_ticks) {
+        const int32_t x = tick.index % GDC_Chunk::SIZE;
+        const int32_t z = (tick.index / GDC_Chunk::SIZE) % GDC_Chunk::SIZE;
+        const int32_t y = tick.index / (GDC_Chunk::SIZE * GDC_Chunk::SIZE);
+        block_ticks.push_back({ Vector3i(tick.chunk_x * GDC_Chunk::SIZE + x, y, tick.chunk_z * GDC_Chunk::SIZE + z), false });
+    }
+    collect_random_ticks();
+
+    int64_t ran = 0;
+    begin_edit();
+    for (const BlockTick &tick : block_ticks) {
+        ran += run_block_tick(tick) ? 1 : 0;
+    }
+    commit_edit();
+
+    ticking = false;
+    perf_stats.add_block_ticks(ran, GDC_PerfStats::get_ticks_usec() - start);
+}
+
+int64_t GDC_World::get_game_tick() const {
+    return game_tick;
+}
+
+int64_t GDC_World::get_scheduled_tick_count() const {
+    return tick_scheduler.get_pending_count();
+}
+
+float GDC_World::get_ticks_per_second() const {
+    return ticks_per_second;
+}
+
+void GDC_World::set_ticks_per_second(float p_rate) {
+    ticks_per_second = MAX(p_rate, 0.0f);
+}
+
+int32_t GDC_World::get_random_tick_speed() const {
+    return random_tick_speed;
+}
+
+void GDC_World::set_random_tick_speed(int32_t p_speed) {
+    random_tick_speed = MAX(p_speed, 0);
+}
+
+void GDC_World::update_ticks(double p_delta) {
+    if (ticks_per_second <= 0.0f) { return; }
+    const double interval = 1.0 / ticks_per_second;
+    tick_time = MIN(tick_time + p_delta, interval * MAX_TICKS_PER_FRAME);
+    while (tick_time >= interval) {
+        tick_time -= interval;
+        run_tick();
+    }
+}
+
+// Sections are skipped on their palette alone, so a tick costs little more
+// than a palette check per section unless the section has randomly ticked
+// blocks.
+void GDC_World::collect_random_ticks() {
+    if (random_tick_speed <= 0) { return; }
+    const GDC_BlockTable &blocks = GDC_Chunk::get_block_table();
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        const GDC_ChunkData &data = E.value->get_data();
+        for (int32_t section = 0; section < GDC_Chunk::SECTION_COUNT; ++section) {
+            if (!data.has_random_ticks(section, blocks)) { continue; }
+
+            const GDC_BlockStorage &storage = data.get_section_storage(section);
+            for (int32_t i = 0; i < random_tick_speed; ++i) {
+                const int32_t index = int32_t(next_random_tick(random_tick_state) % GDC_Chunk::SECTION_VOLUME);
+                if (!blocks.has_random_ticks(storage.get(index))) { continue; }
+
+                const int32_t x = index % GDC_Chunk::SIZE;
+                const int32_t z = (index / GDC_Chunk::SIZE) % GDC_Chunk::SIZE;
+                const int32_t y = section * GDC_Chunk::SECTION_HEIGHT + index / (GDC_Chunk::SIZE * GDC_Chunk::SIZE);
+                block_ticks.push_back({ Vector3i(E.key.x * GDC_Chunk::SIZE + x, y, E.key.y * GDC_Chunk::SIZE + z), true });
             }
         }
     }
-    return Variant();
+}
+
+bool GDC_World::run_block_tick(const BlockTick &p_tick) {
+    GDC_BlockRegistry *p_registry = GDC_BlockRegistry::get_singleton();
+    if (!p_registry) { return false; }
+
+    const int32_t id = get_block_at(Vector3(p_tick.position));
+    if (id <= 0) { return false; }
+    if (p_tick.random && !GDC_Chunk::get_block_table().has_random_ticks(id)) { return false; }
+    const Callable handler = p_registry->get_tick_handler(id);
+    if (!handler.is_valid()) { return false; }
+
+    handler.call(this, p_tick.position, id, p_tick.random);
+    return true;
+}
+
+Variant GDC_World::raycast(Vector3 from, Vector3 dir, float max_dist) {
+    const uint64_t start = GDC_PerfStats::get_ticks_usec();
+    GDC_RayHit hit;
+    const bool found = cast_ray(from, dir, max_dist, hit);
+    perf_stats.add_raycasts(1, GDC_PerfStats::get_ticks_usec() - start);
+    if (!found) { return Variant(); }
+
+    Ref<GDC_HitPayload> payload;
+    payload.instantiate();
+    payload->set_block_pos(Vector3i(hit.block_pos[0], hit.block_pos[1], hit.block_pos[2]));
+    payload->set_normal(Vector3i(hit.normal[0], hit.normal[1], hit.normal[2]));
+    payload->set_block_id(hit.block_id);
+    return payload;
+}
+
+PackedInt32Array GDC_World::raycast_batch(const PackedVector3Array &origins, const PackedVector3Array &dirs, float max_dist) const {
+    PackedInt32Array results;
+    ERR_FAIL_COND_V_MSG(origins.size() != dirs.size(), results, "raycast_batch needs one direction per origin.");
+
+    const int32_t count = static_cast<int32_t>(origins.size());
+    results.resize(static_cast<int64_t>(count) * RAYCAST_STRIDE);
+    if (count == 0) { return results; }
+
+    RaycastBatch batch;
+    batch.p_world = this;
+    batch.p_origins = origins.ptr();
+    batch.p_dirs = dirs.ptr();
+    batch.max_dist = max_dist;
+    batch.count = count;
+    batch.p_results = results.ptrw();
+
+    const uint64_t start = GDC_PerfStats::get_ticks_usec();
+
+    // Nothing edits the chunks while this call blocks the main thread, so the
+    // workers can read them without locking.
+    const int32_t groups = (count + RAYCAST_GROUP_SIZE - 1) / RAYCAST_GROUP_SIZE;
+    if (groups == 1) {
+        raycast_batch_task(&batch, 0);
+    } else {
+        WorkerThreadPool *p_pool = WorkerThreadPool::get_singleton();
+        const WorkerThreadPool::GroupID group_id = p_pool->add_native_group_task(
+                &GDC_World::raycast_batch_task, &batch, groups, -1, true, "GDC_World raycast batch");
+        p_pool->wait_for_group_task_completion(group_id);
+    }
+    perf_stats.add_raycasts(count, GDC_PerfStats::get_ticks_usec() - start);
+    return results;
+}
+
+void GDC_World::raycast_batch_task(void *p_userdata, uint32_t p_index) {
+    const RaycastBatch *p_batch = static_cast<const RaycastBatch *>(p_userdata);
+    const int32_t begin = static_cast<int32_t>(p_index) * RAYCAST_GROUP_SIZE;
+    const int32_t end = MIN(begin + RAYCAST_GROUP_SIZE, p_batch->count);
+
+    for (int32_t i = begin; i < end; ++i) {
+        int32_t *p_out = p_batch->p_results + static_cast<int64_t>(i) * RAYCAST_STRIDE;
+        GDC_RayHit hit;
+        if (!p_batch->p_world->cast_ray(p_batch->p_origins[i], p_batch->p_dirs[i], p_batch->max_dist, hit)) {
+            std::fill_n(p_out, RAYCAST_STRIDE, 0);
+            continue;
+        }
+        p_out[0] = hit.block_id;
+        p_out[1] = hit.block_pos[0];
+        p_out[2] = hit.block_pos[1];
+        p_out[3] = hit.block_pos[2];
+        p_out[4] = hit.normal[0];
+        p_out[5] = hit.normal[1];
+        p_out[6] = hit.normal[2];
+    }
+}
+
+const GDC_ChunkData *GDC_World::find_chunk_data(int32_t p_chunk_x, int32_t p_chunk_z, const void *p_userdata) {
+    const GDC_World *p_world = static_cast<const GDC_World *>(p_userdata);
+    GDC_Chunk *const *p_found = p_world->p_chunks.getptr(Vector2i(p_chunk_x, p_chunk_z));
+    return p_found != nullptr ? &(*p_found)->get_data() : nullptr;
+}
+
+// See GDC_VoxelRaycaster::cast(); the chunks' block data is linked the same way
+// as the chunks themselves. Batched rays read the registry's block table from
+// worker threads while the main thread waits for them, so it cannot reload.
+bool GDC_World::cast_ray(Vector3 from, Vector3 dir, float max_dist, GDC_RayHit &r_hit) const {
+    return GDC_VoxelRaycaster::cast({ from.x, from.y, from.z }, { dir.x, dir.y, dir.z }, max_dist,
+            &GDC_World::find_chunk_data, this, GDC_Chunk::get_block_table(), r_hit);
+}
+
+int32_t GDC_World::get_chunk_count() const {
+    return p_chunks.size();
+}
+
+int64_t GDC_World::get_block_storage_bytes() const {
+    int64_t total = 0;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        total += E.value->get_block_storage_bytes();
+    }
+    return total;
+}
+
+GDC_Chunk::MeshingMode GDC_World::get_meshing_mode() const {
+    return meshing_mode;
+}
+
+// Applies to every registered chunk and to chunks registered later; a chunk can
+// still override its own mode after registration.
+void GDC_World::set_meshing_mode(GDC_Chunk::MeshingMode p_mode) {
+    meshing_mode = p_mode;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        E.value->set_meshing_mode(p_mode);
+    }
+}
+
+GDC_Chunk::VertexFormat GDC_World::get_vertex_format() const {
+    return vertex_format;
+}
+
+// Like set_meshing_mode(), but also remeshes every chunk so the whole world
+// switches format.
+void GDC_World::set_vertex_format(GDC_Chunk::VertexFormat p_format) {
+    if (vertex_format == p_format) { return; }
+
+    vertex_format = p_format;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        E.value->set_vertex_format(p_format);
+        E.value->mark_all_sections_dirty();
+        mark_chunk_dirty(E.key);
+    }
+}
+
+int64_t GDC_World::get_mesh_bytes() const {
+    int64_t total = 0;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        total += E.value->get_mesh_bytes();
+    }
+    return total;
+}
+
+void GDC_World::mark_chunk_dirty(Vector2i coord) {
+    if (p_chunks.has(coord)) {
+        dirty_chunks.insert(coord);
+    }
+}
+
+// The chunk and the neighbours an edit touching the given borders can dirty
+// (see GDC_Chunk::mark_border_dirty()): one per border, and the diagonal one
+// where two borders meet.
+void GDC_World::mark_border_chunks_dirty(Vector2i coord, bool p_nx, bool p_px, bool p_nz, bool p_pz) {
+    mark_chunk_dirty(coord);
+    if (p_nx) { mark_chunk_dirty(coord + Vector2i(-1, 0)); }
+    if (p_px) { mark_chunk_dirty(coord + Vector2i(1, 0)); }
+    if (p_nz) { mark_chunk_dirty(coord + Vector2i(0, -1)); }
+    if (p_pz) { mark_chunk_dirty(coord + Vector2i(0, 1)); }
+    if (p_nx && p_nz) { mark_chunk_dirty(coord + Vector2i(-1, -1)); }
+    if (p_nx && p_pz) { mark_chunk_dirty(coord + Vector2i(-1, 1)); }
+    if (p_px && p_nz) { mark_chunk_dirty(coord + Vector2i(1, -1)); }
+    if (p_px && p_pz) { mark_chunk_dirty(coord + Vector2i(1, 1)); }
+}
+
+// Worker threads pick up tasks roughly in submission order, so while streaming
+// the chunks closest to and in front of the viewer are meshed first.
+void GDC_World::flush_dirty_chunks() {
+    // Light spreads past the edited chunks, into sections nothing else marked.
+    // Edits made on a GDC_Chunk directly, like fill(), only dirty its sections
+    // and its neighbours'; they join the dirty set here.
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        if (E.value->take_light_changes() || E.value->has_dirty_sections()) {
+            dirty_chunks.insert(E.key);
+        }
+    }
+    if (dirty_chunks.is_empty()) { return; }
+
+    std::vector<Vector2i> coords;
+    coords.reserve(dirty_chunks.size());
+    for (const Vector2i &coord : dirty_chunks) {
+        coords.push_back(coord);
+    }
+    dirty_chunks.clear();
+
+    if (streaming_enabled) {
+        std::sort(coords.begin(), coords.end(), [this](const Vector2i &a, const Vector2i &b) {
+            return get_load_priority(a) < get_load_priority(b);
+        });
+    }
+    for (const Vector2i &coord : coords) {
+        queue_chunk_mesh(coord);
+    }
+}
+
+bool GDC_World::is_streaming_enabled() const {
+    return streaming_enabled;
+}
+
+void GDC_World::set_streaming_enabled(bool p_enabled) {
+    streaming_enabled = p_enabled;
+    load_queue_valid = false;
+}
+
+NodePath GDC_World::get_viewer() const {
+    return viewer;
+}
+
+void GDC_World::set_viewer(const NodePath &p_viewer) {
+    viewer = p_viewer;
+    load_queue_valid = false;
+}
+
+int32_t GDC_World::get_load_radius() const {
+    return load_radius;
+}
+
+void GDC_World::set_load_radius(int32_t p_radius) {
+    load_radius = MAX(p_radius, 1);
+    unload_radius = MAX(unload_radius, load_radius + 1);
+    load_queue_valid = false;
+}
+
+int32_t GDC_World::get_unload_radius() const {
+    return unload_radius;
+}
+
+void GDC_World::set_unload_radius(int32_t p_radius) {
+    unload_radius = MAX(p_radius, load_radius + 1);
+    load_queue_valid = false;
+}
+
+int32_t GDC_World::get_max_loads_per_frame() const {
+    return max_loads_per_frame;
+}
+
+void GDC_World::set_max_loads_per_frame(int32_t p_count) {
+    max_loads_per_frame = MAX(p_count, 1);
+}
+
+Ref<GDC_TerrainGenerator> GDC_World::get_terrain_generator() const {
+    return terrain_generator;
+}
+
+void GDC_World::set_terrain_generator(const Ref<GDC_TerrainGenerator> &p_generator) {
+    terrain_generator = p_generator;
+    load_queue_valid = false;
+}
+
+int32_t GDC_World::get_pending_generate_jobs() const {
+    return generate_jobs.size();
+}
+
+int32_t GDC_World::get_collision_radius() const {
+    return collision_radius;
+}
+
+void GDC_World::set_collision_radius(int32_t p_radius) {
+    collision_radius = MAX(p_radius, 0);
+}
+
+int32_t GDC_World::get_collision_chunk_count() const {
+    return collision_chunks.size();
+}
+
+// Enables collision on chunks that came within collision_radius of a body,
+// disables it once they are a chunk further away than that, and rebuilds the
+// sections edited since the last frame.
+void GDC_World::update_collision() {
+    std::vector<Vector2i> centers;
+    if (Node3D *p_viewer = Object::cast_to<Node3D>(get_node_or_null(viewer))) {
+        centers.push_back(world_pos_to_chunk_coord(to_local(p_viewer->get_global_position())));
+    }
+    if (is_inside_tree()) {
+        const TypedArray<Node> bodies = get_tree()->get_nodes_in_group(COLLISION_GROUP);
+        for (int64_t i = 0; i < bodies.size(); ++i) {
+            if (Node3D *p_body = Object::cast_to<Node3D>(bodies[i])) {
+                centers.push_back(world_pos_to_chunk_coord(to_local(p_body->get_global_position())));
+            }
+        }
+    }
+
+    auto distance_to_centers = [&centers](Vector2i coord) {
+        int32_t best = INT32_MAX;
+        for (const Vector2i &center : centers) {
+            best = MIN(best, MAX(std::abs(coord.x - center.x), std::abs(coord.y - center.y)));
+        }
+        return best;
+    };
+
+    if (!centers.empty()) {
+        std::vector<Vector2i> released;
+        for (const Vector2i &coord : collision_chunks) {
+            if (distance_to_centers(coord) > collision_radius + 1) {
+                released.push_back(coord);
+            }
+        }
+        for (const Vector2i &coord : released) {
+            collision_chunks.erase(coord);
+            if (GDC_Chunk *p_chunk = get_chunk(coord)) {
+                p_chunk->set_collision_enabled(false);
+            }
+        }
+    }
+
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        // Coarse chunks never collide; set_lod() already freed their shapes.
+        if (E.value->get_lod() > 0) {
+            collision_chunks.erase(E.key);
+            continue;
+        }
+        if (!collision_chunks.has(E.key)) {
+            if (!centers.empty() && distance_to_centers(E.key) > collision_radius) { continue; }
+            collision_chunks.insert(E.key);
+            E.value->set_collision_enabled(true);
+        }
+        E.value->update_collision();
+    }
+}
+
+float GDC_World::get_lod_distance() const {
+    return lod_distance;
+}
+
+void GDC_World::set_lod_distance(float p_distance) {
+    lod_distance = MAX(p_distance, 0.0f);
+}
+
+int32_t GDC_World::get_max_lod() const {
+    return max_lod;
+}
+
+void GDC_World::set_max_lod(int32_t p_lod) {
+    max_lod = CLAMP(p_lod, 0, GDC_Chunk::MAX_LOD);
+}
+
+void GDC_World::update_lods() {
+    Node3D *p_eye = is_inside_tree() ? get_viewport()->get_camera_3d() : nullptr;
+    if (p_eye == nullptr) {
+        p_eye = Object::cast_to<Node3D>(get_node_or_null(viewer));
+    }
+    const bool has_position = p_eye != nullptr;
+    const Vector3 position = has_position ? to_local(p_eye->get_global_position()) : Vector3();
+
+    const float half_size = GDC_Chunk::SIZE * 0.5f;
+    std::vector<Vector2i> changed;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        const int32_t current = E.value->get_lod();
+        int32_t lod = 0;
+        if (has_position && lod_distance > 0.0f) {
+            const Vector2 center(E.key.x * GDC_Chunk::SIZE + half_size, E.key.y * GDC_Chunk::SIZE + half_size);
+            const float steps = Vector2(position.x, position.z).distance_to(center) / (GDC_Chunk::SIZE * lod_distance);
+            lod = current;
+            if (steps < current - LOD_HYSTERESIS || steps >= current + 1 + LOD_HYSTERESIS) {
+                lod = static_cast<int32_t>(steps);
+            }
+        }
+        lod = MIN(lod, max_lod);
+        if (lod != current) {
+            E.value->set_lod(lod);
+            changed.push_back(E.key);
+        }
+    }
+
+    // Both sides of a seam mesh their border differently depending on whether
+    // the LODs match.
+    for (const Vector2i &coord : changed) {
+        mark_chunk_dirty(coord);
+        for (int32_t i = 0; i < 4; ++i) {
+            if (GDC_Chunk *p_neighbour = get_chunk(coord + NEIGHBOUR_OFFSETS[i])) {
+                p_neighbour->mark_all_sections_dirty();
+                mark_chunk_dirty(coord + NEIGHBOUR_OFFSETS[i]);
+            }
+        }
+    }
+}
+
+bool GDC_World::is_cave_culling_enabled() const {
+    return cave_culling_enabled;
+}
+
+void GDC_World::set_cave_culling_enabled(bool p_enabled) {
+    cave_culling_enabled = p_enabled;
+}
+
+int32_t GDC_World::get_visible_chunk_count() const {
+    return visible_chunk_count;
+}
+
+int32_t GDC_World::get_visible_section_count() const {
+    return visible_section_count;
+}
+
+int32_t GDC_World::find_section_face_links(int32_t p_chunk_x, int32_t p_chunk_z, int32_t section, int32_t entry_face, const void *p_userdata) {
+    const GDC_World *p_world = static_cast<const GDC_World *>(p_userdata);
+    GDC_Chunk *const *p_found = p_world->p_chunks.getptr(Vector2i(p_chunk_x, p_chunk_z));
+    if (p_found == nullptr) { return -1; }
+    return entry_face >= 0 ? (*p_found)->get_section_face_links(section, entry_face) : GDC_Chunk::ALL_SECTION_FACES;
+}
+
+// See GDC_SectionVisibility::search(); it starts from the camera's section, and
+// the sections it does not reach are culled.
+void GDC_World::update_visibility() {
+    visibility.clear();
+    bool cull = false;
+
+    Camera3D *p_camera = (cave_culling_enabled && is_inside_tree()) ? get_viewport()->get_camera_3d() : nullptr;
+    if (p_camera != nullptr) {
+        const Vector3 position = to_local(p_camera->get_global_position());
+        const Vector2i start = world_pos_to_chunk_coord(position);
+        const int32_t start_section = CLAMP(static_cast<int32_t>(floorf(position.y / GDC_Chunk::SECTION_HEIGHT)),
+                0, GDC_Chunk::SECTION_COUNT - 1);
+
+        // Outside the loaded world there is nothing to search from.
+        cull = visibility.search(start.x, start.y, start_section, &GDC_World::find_section_face_links, this);
+    }
+
+    visible_chunk_count = 0;
+    visible_section_count = 0;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        const uint8_t mask = !cull ? 0xff : visibility.get_visible_sections(E.key.x, E.key.y);
+        for (int32_t i = 0; i < GDC_Chunk::SECTION_COUNT; ++i) {
+            const bool visible = mask & (1 << i);
+            E.value->set_section_culled(i, !visible);
+            visible_section_count += visible ? 1 : 0;
+        }
+        visible_chunk_count += mask != 0 ? 1 : 0;
+    }
+}
+
+void GDC_World::update_streaming() {
+    Node3D *p_viewer = Object::cast_to<Node3D>(get_node_or_null(viewer));
+    if (p_viewer == nullptr || terrain_generator.is_null()) { return; }
+
+    const Vector3 position = to_local(p_viewer->get_global_position());
+    const Vector2i center = world_pos_to_chunk_coord(position);
+
+    Vector3 forward = -p_viewer->get_global_transform().basis.get_column(2);
+    forward.y = 0.0f;
+    forward = forward.is_zero_approx() ? Vector3(0, 0, -1) : forward.normalized();
+
+    if (!load_queue_valid || center != stream_center || forward.dot(stream_forward) < VIEW_RESORT_DOT) {
+        const bool moved = !load_queue_valid || center != stream_center;
+        stream_center = center;
+        stream_forward = forward;
+        if (moved) {
+            unload_far_chunks();
+        }
+        rebuild_load_queue();
+    }
+
+    start_generate_jobs();
+}
+
+void GDC_World::rebuild_load_queue() {
+    load_queue.clear();
+    load_queue_pos = 0;
+    load_queue_valid = true;
+
+    for (int32_t dz = -load_radius; dz <= load_radius; ++dz) {
+        for (int32_t dx = -load_radius; dx <= load_radius; ++dx) {
+            const Vector2i coord = stream_center + Vector2i(dx, dz);
+            if (!is_within_radius(coord, load_radius)) { continue; }
+            if (p_chunks.has(coord) || generate_jobs.has(coord)) { continue; }
+            load_queue.push_back(coord);
+        }
+    }
+
+    std::sort(load_queue.begin(), load_queue.end(), [this](const Vector2i &a, const Vector2i &b) {
+        return get_load_priority(a) < get_load_priority(b);
+    });
+}
+
+void GDC_World::unload_far_chunks() {
+    std::vector<Vector2i> far_chunks;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        if (!is_within_radius(E.key, unload_radius)) {
+            far_chunks.push_back(E.key);
+        }
+    }
+    for (const Vector2i &coord : far_chunks) {
+        unload_chunk(coord);
+    }
+}
+
+void GDC_World::start_generate_jobs() {
+    if (load_queue_pos >= load_queue.size()) { return; }
+
+    GDC_TerrainGenerator::Layers layers;
+    if (!terrain_generator->resolve_layers(layers)) {
+        load_queue_pos = load_queue.size();
+        return;
+    }
+    const GDC_BlockTable &blocks = GDC_Chunk::get_block_table();
+
+    // Keep roughly one frame of work in flight beyond what is started now.
+    const int32_t max_in_flight = max_loads_per_frame * 2;
+    int32_t started = 0;
+    while (load_queue_pos < load_queue.size() && started < max_loads_per_frame && static_cast<int32_t>(generate_jobs.size()) < max_in_flight) {
+        const Vector2i coord = load_queue[load_queue_pos++];
+        if (p_chunks.has(coord) || generate_jobs.has(coord)) { continue; }
+
+        // Let a pending save of the same chunk land before reading it back.
+        if (SaveJob **p_save = save_jobs.getptr(coord)) {
+            finish_save_job(*p_save);
+        }
+
+        GenerateJob *p_job = memnew(GenerateJob);
+        p_job->coord = coord;
+        p_job->p_chunk = acquire_chunk();
+        p_job->generator = terrain_generator;
+        p_job->layers = layers;
+        p_job->blocks = blocks;
+        p_job->p_store = p_region_store;
+        p_job->task_id = WorkerThreadPool::get_singleton()->add_native_task(
+                &GDC_World::generate_job_task, p_job, false, "GDC_World generate job");
+        generate_jobs.insert(coord, p_job);
+        ++started;
+    }
+}
+
+void GDC_World::poll_generate_jobs() {
+    std::vector<GenerateJob *> completed;
+    for (const KeyValue<Vector2i, GenerateJob *> &E : generate_jobs) {
+        if (WorkerThreadPool::get_singleton()->is_task_completed(E.value->task_id)) {
+            completed.push_back(E.value);
+        }
+    }
+
+    for (GenerateJob *p_job : completed) {
+        finish_generate_job(p_job);
+    }
+}
+
+void GDC_World::finish_generate_job(GenerateJob *p_job) {
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(p_job->task_id);
+    generate_jobs.erase(p_job->coord);
+
+    // The viewer may have moved away while the chunk was being generated.
+    if (streaming_enabled && is_within_radius(p_job->coord, unload_radius) && !p_chunks.has(p_job->coord)) {
+        // Generated chunks are saved on unload so that revisiting them skips
+        // the generator; loaded ones only once they are edited.
+        p_job->p_chunk->set_modified(!p_job->loaded);
+        register_chunk(p_job->p_chunk, p_job->coord);
+    } else {
+        release_chunk(p_job->p_chunk);
+    }
+    memdelete(p_job);
+}
+
+void GDC_World::generate_job_task(void *p_userdata) {
+    GenerateJob *p_job = static_cast<GenerateJob *>(p_userdata);
+
+    thread_local std::vector<int32_t> ids;
+    ids.resize(GDC_Chunk::BLOCK_COUNT);
+
+    p_job->loaded = p_job->p_store != nullptr && p_job->p_store->load_chunk(p_job->coord, ids.data());
+    if (!p_job->loaded) {
+        p_job->generator->generate_column(p_job->layers, p_job->coord, ids.data());
+    }
+    p_job->p_chunk->load_block_data(ids.data(), p_job->blocks);
+}
+
+String GDC_World::get_save_path() const {
+    return save_path;
+}
+
+void GDC_World::set_save_path(const String &p_path) {
+    if (p_path == save_path) { return; }
+
+    close_region_store();
+    save_path = p_path;
+    open_region_store();
+}
+
+// Queues a background save of the chunk if it has unsaved changes. Returns
+// false when there is nothing to save or saving is disabled.
+bool GDC_World::save_chunk(Vector2i coord) {
+    GDC_Chunk *p_chunk = get_chunk(coord);
+    if (p_region_store == nullptr || p_chunk == nullptr || !p_chunk->is_modified()) { return false; }
+
+    start_save_job(coord, p_chunk);
+    return true;
+}
+
+// Saves every modified chunk and blocks until all saves are written. Returns
+// the number of chunks saved.
+int32_t GDC_World::save_world() {
+    if (p_region_store == nullptr) { return 0; }
+
+    int32_t count = 0;
+    for (const KeyValue<Vector2i, GDC_Chunk *> &E : p_chunks) {
+        if (E.value->is_modified()) {
+            start_save_job(E.key, E.value);
+            ++count;
+        }
+    }
+
+    std::vector<SaveJob *> pending;
+    for (const KeyValue<Vector2i, SaveJob *> &E : save_jobs) {
+        pending.push_back(E.value);
+    }
+    for (SaveJob *p_job : pending) {
+        finish_save_job(p_job);
+    }
+    return count;
+}
+
+int32_t GDC_World::get_pending_save_jobs() const {
+    return save_jobs.size();
+}
+
+void GDC_World::open_region_store() {
+    if (save_path.is_empty()) { return; }
+
+    const String directory = ProjectSettings::get_singleton()->globalize_path(save_path);
+    const Error err = DirAccess::make_dir_recursive_absolute(directory);
+    ERR_FAIL_COND_MSG(err != OK, "GDC_World: could not create save directory " + directory + ".");
+
+    p_region_store = memnew(GDC_RegionStore(std::string(directory.utf8().get_data())));
+}
+
+// Waits for everything that may still hold the store, then closes it.
+void GDC_World::close_region_store() {
+    if (p_region_store == nullptr) { return; }
+
+    std::vector<SaveJob *> pending;
+    for (const KeyValue<Vector2i, SaveJob *> &E : save_jobs) {
+        pending.push_back(E.value);
+    }
+    for (SaveJob *p_job : pending) {
+        finish_save_job(p_job);
+    }
+
+    std::vector<GenerateJob *> generating;
+    for (const KeyValue<Vector2i, GenerateJob *> &E : generate_jobs) {
+        generating.push_back(E.value);
+    }
+    for (GenerateJob *p_job : generating) {
+        finish_generate_job(p_job);
+    }
+
+    memdelete(p_region_store);
+    p_region_store = nullptr;
+}
+
+// The blocks are copied on the main thread so the chunk can be edited or freed
+// right away; compression and the write happen on a worker thread.
+void GDC_World::start_save_job(Vector2i coord, GDC_Chunk *p_chunk) {
+    // Saves of one chunk are kept in order.
+    if (SaveJob **p_previous = save_jobs.getptr(coord)) {
+        finish_save_job(*p_previous);
+    }
+
+    SaveJob *p_job = memnew(SaveJob);
+    p_job->coord = coord;
+    p_job->ids.resize(GDC_Chunk::BLOCK_COUNT);
+    p_job->p_store = p_region_store;
+    p_chunk->store_block_data(p_job->ids.data());
+    p_chunk->set_modified(false);
+
+    p_job->task_id = WorkerThreadPool::get_singleton()->add_native_task(
+            &GDC_World::save_job_task, p_job, false, "GDC_World save job");
+    save_jobs.insert(coord, p_job);
+}
+
+void GDC_World::finish_save_job(SaveJob *p_job) {
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(p_job->task_id);
+    save_jobs.erase(p_job->coord);
+
+    if (!p_job->saved) {
+        ERR_PRINT("GDC_World: failed to save chunk " + String(p_job->coord) + ".");
+        // Keep the edits around for the next save if the chunk is still loaded.
+        if (GDC_Chunk *p_chunk = get_chunk(p_job->coord)) {
+            p_chunk->set_modified(true);
+        }
+    }
+    memdelete(p_job);
+}
+
+void GDC_World::poll_save_jobs() {
+    std::vector<SaveJob *> completed;
+    for (const KeyValue<Vector2i, SaveJob *> &E : save_jobs) {
+        if (WorkerThreadPool::get_singleton()->is_task_completed(E.value->task_id)) {
+            completed.push_back(E.value);
+        }
+    }
+    for (SaveJob *p_job : completed) {
+        finish_save_job(p_job);
+    }
+}
+
+void GDC_World::save_job_task(void *p_userdata) {
+    SaveJob *p_job = static_cast<SaveJob *>(p_userdata);
+    p_job->saved = p_job->p_store->save_chunk(p_job->coord, p_job->ids.data());
+}
+
+bool GDC_World::is_within_radius(Vector2i coord, int32_t radius) const {
+    const Vector2i delta = coord - stream_center;
+    return delta.x * delta.x + delta.y * delta.y <= radius * radius;
+}
+
+// Distance in chunks from the viewer, stretched for chunks behind it.
+float GDC_World::get_load_priority(Vector2i coord) const {
+    const Vector2i delta = coord - stream_center;
+    const float distance = std::sqrt(static_cast<float>(delta.x * delta.x + delta.y * delta.y));
+    if (distance == 0.0f) { return 0.0f; }
+
+    const float facing = (delta.x * stream_forward.x + delta.y * stream_forward.z) / distance;
+    return distance * (1.0f + VIEW_PRIORITY_WEIGHT * (1.0f - facing) * 0.5f);
+}
+
+double GDC_World::get_monitor(Monitor p_monitor) const {
+    switch (p_monitor) {
+        case MONITOR_PROCESS_TIME: return perf_stats.get_time_ms(GDC_PerfStats::TIMER_PROCESS);
+        case MONITOR_MESHES_BUILT: return perf_stats.get_meshes_built();
+        case MONITOR_MESH_TIME_MEAN: return perf_stats.get_mesh_time_mean_ms();
+        case MONITOR_MESH_TIME_P99: return perf_stats.get_mesh_time_p99_ms();
+        case MONITOR_MESH_APPLY_TIME: return perf_stats.get_time_ms(GDC_PerfStats::TIMER_MESH_APPLY);
+        case MONITOR_VERTICES_EMITTED: return static_cast<double>(perf_stats.get_vertices_emitted());
+        case MONITOR_COLLISION_BUILD_TIME: return perf_stats.get_time_ms(GDC_PerfStats::TIMER_COLLISION_BUILD);
+        case MONITOR_COLLISION_FREE_TIME: return perf_stats.get_time_ms(GDC_PerfStats::TIMER_COLLISION_FREE);
+        case MONITOR_RAYCASTS: return static_cast<double>(perf_stats.get_raycasts());
+        case MONITOR_RAYCAST_TIME: return perf_stats.get_time_ms(GDC_PerfStats::TIMER_RAYCAST);
+        case MONITOR_LOADED_CHUNKS: return get_chunk_count();
+        case MONITOR_BLOCK_STORAGE_BYTES: return static_cast<double>(get_block_storage_bytes());
+        case MONITOR_MESH_BYTES: return static_cast<double>(get_mesh_bytes());
+        case MONITOR_PENDING_MESH_JOBS: return get_pending_mesh_jobs();
+        case MONITOR_PENDING_GENERATE_JOBS: return get_pending_generate_jobs();
+        case MONITOR_PENDING_SAVE_JOBS: return get_pending_save_jobs();
+        case MONITOR_CHUNK_POOL_HITS: return static_cast<double>(chunk_pool_hits);
+        case MONITOR_CHUNK_POOL_MISSES: return static_cast<double>(chunk_pool_misses);
+        case MONITOR_POOLED_CHUNKS: return get_pooled_chunk_count();
+        case MONITOR_BLOCK_TICKS: return static_cast<double>(perf_stats.get_block_ticks());
+        case MONITOR_BLOCK_TICK_TIME: return perf_stats.get_time_ms(GDC_PerfStats::TIMER_BLOCK_TICKS);
+        case MONITOR_SCHEDULED_TICKS: return static_cast<double>(get_scheduled_tick_count());
+        default: break;
+    }
+    ERR_FAIL_V_MSG(0.0, "Invalid monitor.");
+}
+
+String GDC_World::get_monitor_name(Monitor p_monitor) {
+    ERR_FAIL_INDEX_V(p_monitor, MONITOR_COUNT, String());
+    return MONITOR_NAMES[p_monitor];
+}
+
+// Each monitor calls get_monitor() with its own index bound as the argument.
+void GDC_World::register_monitors() {
+    Performance *p_performance = Performance::get_singleton();
+    if (p_performance->has_custom_monitor(MONITOR_NAMES[0])) { return; }
+
+    for (int32_t i = 0; i < MONITOR_COUNT; ++i) {
+        Array arguments;
+        arguments.push_back(i);
+        p_performance->add_custom_monitor(MONITOR_NAMES[i], Callable(this, "get_monitor"), arguments);
+    }
+    monitors_registered = true;
+}
+
+void GDC_World::unregister_monitors() {
+    if (!monitors_registered) { return; }
+
+    Performance *p_performance = Performance::get_singleton();
+    for (int32_t i = 0; i < MONITOR_COUNT; ++i) {
+        p_performance->remove_custom_monitor(MONITOR_NAMES[i]);
+    }
+    monitors_registered = false;
+}
+
+String GDC_World::get_trace_path() const {
+    return trace_path;
+}
+
+void GDC_World::set_trace_path(const String &p_path) {
+    if (trace_path == p_path) { return; }
+
+    close_trace();
+    trace_path = p_path;
+    if (is_inside_tree() && !Engine::get_singleton()->is_editor_hint()) {
+        open_trace();
+    }
+}
+
+void GDC_World::open_trace() {
+    if (trace_path.is_empty() || trace_file.is_valid()) { return; }
+
+    trace_file = FileAccess::open(trace_path, FileAccess::WRITE);
+    ERR_FAIL_COND_MSG(trace_file.is_null(), "Could not open the trace file " + trace_path + ".");
+
+    String header = "frame";
+    for (int32_t i = 0; i < MONITOR_COUNT; ++i) {
+        header += String(",") + MONITOR_NAMES[i];
+    }
+    trace_file->store_line(header);
+}
+
+void GDC_World::close_trace() {
+    if (trace_file.is_null()) { return; }
+
+    trace_file->flush();
+    trace_file.unref();
+}
+
+void GDC_World::write_trace_frame() {
+    if (trace_file.is_null()) { return; }
+
+    String line = String::num_uint64(Engine::get_singleton()->get_process_frames());
+    for (int32_t i = 0; i < MONITOR_COUNT; ++i) {
+        line += "," + String::num(get_monitor(static_cast<Monitor>(i)), 3);
+    }
+    trace_file->store_line(line);
+}
+
+// Snapshots the chunk's dirty sections now and meshes them on a worker thread.
+// If a job for the chunk is already running, sections dirtied in the meantime
+// are picked up by a follow-up job once it completes.
+void GDC_World::queue_chunk_mesh(Vector2i coord) {
+    GDC_Chunk *p_chunk = get_chunk(coord);
+    if (!p_chunk || mesh_jobs.has(coord)) { return; }
+
+    MeshJob *p_job = acquire_mesh_job();
+    p_job->coord = coord;
+    p_job->p_chunk = p_chunk;
+    if (!start_mesh_job(p_job)) {
+        release_mesh_job(p_job);
+        return;
+    }
+    mesh_jobs.insert(coord, p_job);
+}
+
+void GDC_World::wait_for_chunk_mesh(Vector2i coord) {
+    MeshJob **p_job = mesh_jobs.getptr(coord);
+    while (p_job != nullptr) {
+        finish_mesh_job(*p_job);
+        p_job = mesh_jobs.getptr(coord);
+    }
+}
+
+void GDC_World::wait_for_all_meshes() {
+    while (!mesh_jobs.is_empty()) {
+        wait_for_chunk_mesh(mesh_jobs.begin()->key);
+    }
+}
+
+int32_t GDC_World::get_pending_mesh_jobs() const {
+    return mesh_jobs.size();
+}
+
+GDC_World::MeshJob *GDC_World::acquire_mesh_job() {
+    if (idle_mesh_jobs.empty()) {
+        return memnew(MeshJob);
+    }
+    MeshJob *p_job = idle_mesh_jobs.back();
+    idle_mesh_jobs.pop_back();
+    return p_job;
+}
+
+void GDC_World::release_mesh_job(MeshJob *p_job) {
+    if (static_cast<int32_t>(idle_mesh_jobs.size()) >= MAX_IDLE_MESH_JOBS) {
+        memdelete(p_job);
+        return;
+    }
+    p_job->p_chunk = nullptr;
+    p_job->section_count = 0;
+    idle_mesh_jobs.push_back(p_job);
+}
+
+void GDC_World::mesh_job_task(void *p_userdata) {
+    MeshJob *p_job = static_cast<MeshJob *>(p_userdata);
+    for (int32_t i = 0; i < p_job->section_count; ++i) {
+        SectionJob &section_job = p_job->sections[i];
+        if (!section_job.skip) {
+            const uint64_t start = GDC_PerfStats::get_ticks_usec();
+            GDC_ChunkMesher::build(section_job.snapshot, section_job.buffers);
+            section_job.build_usec = GDC_PerfStats::get_ticks_usec() - start;
+        }
+    }
+}
+
+// Returns false if the chunk had nothing dirty to mesh.
+bool GDC_World::start_mesh_job(MeshJob *p_job) {
+    GDC_Chunk *p_chunk = p_job->p_chunk;
+    p_job->section_count = 0;
+
+    for (int32_t i = 0; i < GDC_Chunk::SECTION_COUNT; ++i) {
+        if (!p_chunk->is_section_dirty(i)) {
+            continue;
+        }
+        p_chunk->clear_section_dirty(i);
+
+        SectionJob &section_job = p_job->sections[p_job->section_count++];
+        section_job.section = i;
+        section_job.build_usec = 0;
+        section_job.skip = p_chunk->is_section_skippable(i);
+        if (section_job.skip) {
+            section_job.buffers.resize(0, false); // drop what a previous use left
+        } else {
+            p_chunk->capture_section_snapshot(i, section_job.snapshot);
+        }
+    }
+
+    if (p_job->section_count == 0) {
+        return false;
+    }
+
+    p_job->task_id = WorkerThreadPool::get_singleton()->add_native_task(
+            &GDC_World::mesh_job_task, p_job, false, "GDC_World mesh job");
+    return true;
+}
+
+// Blocks until the job's task is done, then applies the result on this thread.
+void GDC_World::finish_mesh_job(MeshJob *p_job) {
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(p_job->task_id);
+
+    // Dropped results still cost their build time.
+    for (int32_t i = 0; i < p_job->section_count; ++i) {
+        const SectionJob &section_job = p_job->sections[i];
+        if (!section_job.skip) {
+            perf_stats.add_mesh(section_job.build_usec, section_job.buffers.get_vertex_count());
+        }
+    }
+
+    // The chunk may have been replaced since the job was queued; a stale
+    // result is dropped rather than applied to the new chunk.
+    GDC_Chunk *p_current = get_chunk(p_job->coord);
+    if (p_current != nullptr && p_current == p_job->p_chunk) {
+        for (int32_t i = 0; i < p_job->section_count; ++i) {
+            p_current->apply_section_mesh(p_job->sections[i].section, p_job->sections[i].buffers);
+        }
+    }
+
+    // Sections edited while the job ran are still dirty; mesh them next.
+    if (p_current != nullptr && p_current->has_dirty_sections()) {
+        p_job->p_chunk = p_current;
+        if (start_mesh_job(p_job)) {
+            return;
+        }
+    }
+
+    mesh_jobs.erase(p_job->coord);
+    release_mesh_job(p_job);
 }
 
 } // namespace godot
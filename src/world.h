@@ -1,30 +1,281 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/packed_vector3i_array.hpp>
+#include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/variant.hpp>
 
 #include "chunk.h"
+#include "chunk_mesher.h"
+#include "core/section_visibility.h"
+#include "core/tick_scheduler.h"
+#include "core/voxel_raycaster.h"
 #include "hit_payload.h"
+#include "perf_stats.h"
+#include "region_file.h"
+#include "terrain_generator.h"
 
 namespace godot {
 class GDC_World: public Node3D {
     GDCLASS(GDC_World, Node3D)
 
+    struct SectionJob {
+        int32_t section = 0;
+        bool skip = false; // empty or buried: applied as an empty mesh
+        uint64_t build_usec = 0;
+        GDC_ChunkSnapshot snapshot;
+        GDC_MeshBuffers buffers;
+    };
+
+    // One in-flight meshing job covering a chunk's dirty sections. Snapshots are
+    // taken on the main thread, the buffers are filled on a WorkerThreadPool
+    // thread and applied back in _process. Finished jobs are kept for reuse, so
+    // their snapshots and buffers keep their storage between remeshes.
+    struct MeshJob {
+        Vector2i coord;
+        GDC_Chunk *p_chunk = nullptr;
+        std::array<SectionJob, GDC_Chunk::SECTION_COUNT> sections;
+        int32_t section_count = 0; // leading entries of `sections` in use
+        WorkerThreadPool::TaskID task_id = -1;
+    };
+
+    // Idle mesh jobs beyond this many are freed rather than kept.
+    static const int32_t MAX_IDLE_MESH_JOBS = 16;
+
+    // A streamed-in chunk being filled by the terrain generator on a worker
+    // thread. The chunk is not registered until the job completes.
+    struct GenerateJob {
+        Vector2i coord;
+        GDC_Chunk *p_chunk = nullptr;
+        Ref<GDC_TerrainGenerator> generator;
+        GDC_TerrainGenerator::Layers layers;
+        GDC_BlockTable blocks;
+        GDC_RegionStore *p_store = nullptr; // tried before generating
+        bool loaded = false; // true when the blocks came from the region store
+        WorkerThreadPool::TaskID task_id = -1;
+    };
+
+    // A copy of a chunk's blocks being compressed and written to its region
+    // file on a worker thread.
+    struct SaveJob {
+        Vector2i coord;
+        std::vector<int32_t> ids;
+        GDC_RegionStore *p_store = nullptr;
+        bool saved = false;
+        WorkerThreadPool::TaskID task_id = -1;
+    };
+
+    // Shared by the worker threads of one raycast_batch() call; each group
+    // element casts RAYCAST_GROUP_SIZE consecutive rays.
+    struct RaycastBatch {
+        const GDC_World *p_world = nullptr;
+        const Vector3 *p_origins = nullptr;
+        const Vector3 *p_dirs = nullptr;
+        float max_dist = 0.0f;
+        int32_t count = 0;
+        int32_t *p_results = nullptr;
+    };
+
 protected:
 	static void _bind_methods();
 
 public:
+    // Values registered as Godot custom monitors under "gdcraft/" while a world
+    // is in the tree (see MONITOR_NAMES). Timings are in milliseconds and
+    // per-frame counts refer to the last completed frame.
+    enum Monitor {
+        MONITOR_PROCESS_TIME,
+        MONITOR_MESHES_BUILT,
+        MONITOR_MESH_TIME_MEAN,
+        MONITOR_MESH_TIME_P99,
+        MONITOR_MESH_APPLY_TIME,
+        MONITOR_VERTICES_EMITTED,
+        MONITOR_COLLISION_BUILD_TIME,
+        MONITOR_COLLISION_FREE_TIME,
+        MONITOR_RAYCASTS,
+        MONITOR_RAYCAST_TIME,
+        MONITOR_LOADED_CHUNKS,
+        MONITOR_BLOCK_STORAGE_BYTES,
+        MONITOR_MESH_BYTES,
+        MONITOR_PENDING_MESH_JOBS,
+        MONITOR_PENDING_GENERATE_JOBS,
+        MONITOR_PENDING_SAVE_JOBS,
+        MONITOR_CHUNK_POOL_HITS,
+        MONITOR_CHUNK_POOL_MISSES,
+        MONITOR_POOLED_CHUNKS,
+        MONITOR_BLOCK_TICKS,
+        MONITOR_BLOCK_TICK_TIME,
+        MONITOR_SCHEDULED_TICKS,
+        MONITOR_COUNT,
+    };
+
+    ~GDC_World() override;
+
+    void _process(double p_delta) override;
+    void _enter_tree() override;
+    void _exit_tree() override;
+    void _notification(int p_what);
+
+    // The world owns registered chunks and frees them on unload and when it
+    // is freed itself; unregister_chunk() hands ownership back to the caller.
     void register_chunk(GDC_Chunk *p_chunk, Vector2i coord);
+    GDC_Chunk *unregister_chunk(Vector2i coord);
+    void unload_chunk(Vector2i coord);
 
     GDC_Chunk *get_chunk(Vector2i coord);
     GDC_Chunk *get_chunk_at(Vector3 world_pos);
 
+    // Unloaded chunks are reset and kept in a pool of up to chunk_pool_size
+    // instead of being freed, and new ones are taken from it first, so chunks
+    // keep their server meshes, instances, bodies and shapes across streaming
+    // churn. acquire_chunk() returns an unregistered chunk owned by the caller
+    // until it is registered or released.
+    GDC_Chunk *acquire_chunk();
+    void release_chunk(GDC_Chunk *p_chunk);
+    int32_t get_chunk_pool_size() const;
+    void set_chunk_pool_size(int32_t p_size);
+    int32_t get_pooled_chunk_count() const;
+    int64_t get_chunk_pool_hits() const;
+    int64_t get_chunk_pool_misses() const;
+
     int32_t get_block_at(Vector3 world_pos);
     void set_block_at(Vector3 world_pos, int32_t id);
 
+    // Edits between begin_edit() and the matching commit_edit() only record
+    // which chunks changed; each of them is queued for remeshing once on commit.
+    // Edits outside a batch are flushed the same way once per frame.
+    void begin_edit();
+    void commit_edit();
+    void set_blocks(const PackedVector3iArray &positions, const PackedInt32Array &ids);
+
+    // Bulk access to the blocks in [from, to), spanning any number of chunks.
+    // Ids are in y, z, x order (x varies fastest), like a chunk's own layout.
+    // Blocks outside loaded chunks or the world height read as -1 and are left
+    // alone on write. set_region() marks each changed chunk dirty once and
+    // relights all of them in one pass.
+    PackedInt32Array get_region(Vector3i from, Vector3i to) const;
+    void set_region(Vector3i from, Vector3i to, const PackedInt32Array &ids);
+
+    // Block ticks. The world runs ticks_per_second game ticks a second; each
+    // runs the scheduled ticks that are due, then random_tick_speed random ticks
+    // in every section holding blocks with random_ticks set. A tick calls the
+    // GDC_BlockRegistry tick handler of the block's id, and its edits are
+    // remeshed as one batch. Scheduled ticks of a chunk are dropped when it is
+    // unloaded, and a block has at most one pending tick.
+    bool schedule_tick(Vector3i position, int32_t delay);
+    bool is_tick_scheduled(Vector3i position) const;
+    void run_tick();
+    int64_t get_game_tick() const;
+    int64_t get_scheduled_tick_count() const;
+    float get_ticks_per_second() const;
+    void set_ticks_per_second(float p_rate);
+    int32_t get_random_tick_speed() const;
+    void set_random_tick_speed(int32_t p_speed);
+
+    // Edit replication. With edit recording on, every registered chunk tracks
+    // its edits (see GDC_Chunk::take_delta()) and take_edit_deltas() collects
+    // them into one buffer holding, per edited chunk, its zigzag varint x and z,
+    // the varint byte length of its delta and the delta itself.
+    // apply_edit_deltas() replays such a buffer on the loaded chunks of another
+    // world as one edit batch, so each chunk is remeshed once, and returns how
+    // many chunks it applied. Chunks it has not loaded are skipped; send those
+    // whole with GDC_Chunk.serialize().
+    bool is_edit_recording_enabled() const;
+    void set_edit_recording_enabled(bool p_enabled);
+    PackedByteArray take_edit_deltas();
+    int32_t apply_edit_deltas(const PackedByteArray &deltas);
+
     Variant raycast(Vector3 from, Vector3 dir, float max_dist);
 
+    // Casts one ray per origin/direction pair, spread over the WorkerThreadPool,
+    // and returns RAYCAST_STRIDE ints per ray: block id (0 for a miss), block
+    // position x, y, z and face normal x, y, z.
+    static const int32_t RAYCAST_STRIDE = 7;
+    PackedInt32Array raycast_batch(const PackedVector3Array &origins, const PackedVector3Array &dirs, float max_dist) const;
+
+    int32_t get_chunk_count() const;
+    int64_t get_block_storage_bytes() const;
+
+    GDC_Chunk::MeshingMode get_meshing_mode() const;
+    void set_meshing_mode(GDC_Chunk::MeshingMode p_mode);
+
+    // Applied to every chunk; see GDC_Chunk::get_vertex_format() for the block
+    // id limit of the compact format.
+    GDC_Chunk::VertexFormat get_vertex_format() const;
+    void set_vertex_format(GDC_Chunk::VertexFormat p_format);
+
+    int64_t get_mesh_bytes() const;
+
+    bool is_streaming_enabled() const;
+    void set_streaming_enabled(bool p_enabled);
+    NodePath get_viewer() const;
+    void set_viewer(const NodePath &p_viewer);
+    int32_t get_load_radius() const;
+    void set_load_radius(int32_t p_radius);
+    int32_t get_unload_radius() const;
+    void set_unload_radius(int32_t p_radius);
+    int32_t get_max_loads_per_frame() const;
+    void set_max_loads_per_frame(int32_t p_count);
+    Ref<GDC_TerrainGenerator> get_terrain_generator() const;
+    void set_terrain_generator(const Ref<GDC_TerrainGenerator> &p_generator);
+    int32_t get_pending_generate_jobs() const;
+
+    // Chunks get collision only within collision_radius (in chunks) of the
+    // viewer or of a Node3D in the COLLISION_GROUP group. With neither present
+    // every chunk has collision.
+    static constexpr const char *COLLISION_GROUP = "gdc_collision_bodies";
+    int32_t get_collision_radius() const;
+    void set_collision_radius(int32_t p_radius);
+    int32_t get_collision_chunk_count() const;
+
+    // Chunks further than lod_distance chunks from the camera (the viewer when
+    // there is no camera) are meshed at LOD 1, further than twice that at LOD 2
+    // and so on up to max_lod. 0 keeps every chunk at full detail.
+    float get_lod_distance() const;
+    void set_lod_distance(float p_distance);
+    int32_t get_max_lod() const;
+    void set_max_lod(int32_t p_lod);
+
+    // With cave culling on, sections the camera cannot see through air (caves
+    // behind solid rock, valleys behind hills) are hidden each frame, on top of
+    // Godot's own frustum culling. See update_visibility().
+    bool is_cave_culling_enabled() const;
+    void set_cave_culling_enabled(bool p_enabled);
+    int32_t get_visible_chunk_count() const;
+    int32_t get_visible_section_count() const;
+
+    // Chunks are saved to region files under save_path (empty disables saving)
+    // when they are unloaded and when the world leaves the tree, and streamed
+    // chunks are read back from there before falling back to the generator.
+    String get_save_path() const;
+    void set_save_path(const String &p_path);
+    bool save_chunk(Vector2i coord);
+    int32_t save_world();
+    int32_t get_pending_save_jobs() const;
+
+    double get_monitor(Monitor p_monitor) const;
+    static String get_monitor_name(Monitor p_monitor);
+
+    // With a trace path set, every frame appends one CSV row holding all the
+    // monitors to that file, starting over each time the world enters the tree.
+    String get_trace_path() const;
+    void set_trace_path(const String &p_path);
+
+    void queue_chunk_mesh(Vector2i coord);
+    void wait_for_chunk_mesh(Vector2i coord);
+    void wait_for_all_meshes();
+    int32_t get_pending_mesh_jobs() const;
+
     static inline Vector2i world_pos_to_chunk_coord(Vector3 world_pos) {
         return Vector2i(
             int(floorf(world_pos.x / GDC_Chunk::SIZE)),
@@ -42,7 +293,135 @@ public:
     }
 
 private:
+    static void mesh_job_task(void *p_userdata);
+    static void generate_job_task(void *p_userdata);
+    static void save_job_task(void *p_userdata);
+    static void raycast_batch_task(void *p_userdata, uint32_t p_index);
+
+    static const GDC_ChunkData *find_chunk_data(int32_t p_chunk_x, int32_t p_chunk_z, const void *p_userdata);
+    static int32_t find_section_face_links(int32_t p_chunk_x, int32_t p_chunk_z, int32_t section, int32_t entry_face, const void *p_userdata);
+    bool cast_ray(Vector3 from, Vector3 dir, float max_dist, GDC_RayHit &r_hit) const;
+
+    Transform3D get_chunk_transform(Vector2i coord) const;
+
+    // One loaded chunk's share of a region: the chunk-local box and the index
+    // of its first cell in the region's id array.
+    struct RegionBox {
+        GDC_Chunk *p_chunk = nullptr;
+        Vector2i coord;
+        Vector3i from;
+        Vector3i to;
+        int64_t offset = 0;
+    };
+    void get_region_boxes(Vector3i from, Vector3i to, std::vector<RegionBox> &r_boxes) const;
+    void place_chunk(GDC_Chunk *p_chunk, Vector2i coord);
+
+    // A tick taken from the scheduler or picked at random, run once all of the
+    // game tick's ticks are collected.
+    struct BlockTick {
+        Vector3i position;
+        bool random = false;
+    };
+    void update_ticks(double p_delta);
+    void collect_random_ticks();
+    bool run_block_tick(const BlockTick &p_tick);
+
+    void update_streaming();
+    void rebuild_load_queue();
+    void unload_far_chunks();
+    void start_generate_jobs();
+    void poll_generate_jobs();
+    void finish_generate_job(GenerateJob *p_job);
+    bool is_within_radius(Vector2i coord, int32_t radius) const;
+    float get_load_priority(Vector2i coord) const;
+
+    void open_region_store();
+    void close_region_store();
+    void start_save_job(Vector2i coord, GDC_Chunk *p_chunk);
+    void finish_save_job(SaveJob *p_job);
+    void poll_save_jobs();
+
+    void register_monitors();
+    void unregister_monitors();
+    void open_trace();
+    void close_trace();
+    void write_trace_frame();
+
+    void update_collision();
+    void update_lods();
+    void update_visibility();
+
+    void mark_chunk_dirty(Vector2i coord);
+    void mark_border_chunks_dirty(Vector2i coord, bool p_nx, bool p_px, bool p_nz, bool p_pz);
+    void flush_dirty_chunks();
+
+    MeshJob *acquire_mesh_job();
+    void release_mesh_job(MeshJob *p_job);
+    bool start_mesh_job(MeshJob *p_job);
+    void finish_mesh_job(MeshJob *p_job);
+
     HashMap<Vector2i, GDC_Chunk *> p_chunks;
+    std::vector<GDC_Chunk *> chunk_pool;
+    int32_t chunk_pool_size = 64;
+    int64_t chunk_pool_hits = 0;
+    int64_t chunk_pool_misses = 0;
+    HashMap<Vector2i, MeshJob *> mesh_jobs;
+    std::vector<MeshJob *> idle_mesh_jobs;
+    HashSet<Vector2i> dirty_chunks;
+    int32_t edit_depth = 0;
+    bool edit_recording_enabled = false;
+
+    GDC_TickScheduler tick_scheduler;
+    std::vector<GDC_TickScheduler::Tick> due_ticks;
+    std::vector<BlockTick> block_ticks;
+    int64_t game_tick = 0;
+    double tick_time = 0.0; // seconds not yet turned into game ticks
+    float ticks_per_second = 20.0f;
+    int32_t random_tick_speed = 3; // random ticks per section per game tick
+    uint64_t random_tick_state = 0x9e3779b97f4a7c15ull;
+    bool ticking = false;
+    GDC_Chunk::MeshingMode meshing_mode = GDC_Chunk::MESHING_GREEDY;
+    GDC_Chunk::VertexFormat vertex_format = GDC_Chunk::VERTEX_FORMAT_STANDARD;
+
+    // Streaming: chunks within load_radius of the viewer are generated, those
+    // beyond unload_radius are freed. The gap between the two is the hysteresis
+    // band that stops chunks flickering in and out at the edge.
+    bool streaming_enabled = false;
+    NodePath viewer;
+    int32_t load_radius = 8;
+    int32_t unload_radius = 10;
+    int32_t max_loads_per_frame = 4;
+    Ref<GDC_TerrainGenerator> terrain_generator;
+
+    HashMap<Vector2i, GenerateJob *> generate_jobs;
+    std::vector<Vector2i> load_queue; // sorted by get_load_priority()
+    size_t load_queue_pos = 0;
+    bool load_queue_valid = false;
+    Vector2i stream_center;
+    Vector3 stream_forward = Vector3(0, 0, -1);
+
+    int32_t collision_radius = 2;
+    HashSet<Vector2i> collision_chunks;
+
+    float lod_distance = 0.0f;
+    int32_t max_lod = GDC_Chunk::MAX_LOD;
+
+    bool cave_culling_enabled = false;
+    GDC_SectionVisibility visibility;
+    int32_t visible_chunk_count = 0;
+    int32_t visible_section_count = 0;
+
+    String save_path;
+    GDC_RegionStore *p_region_store = nullptr;
+    HashMap<Vector2i, SaveJob *> save_jobs;
+
+    // Written from const raycasts too; only ever touched on the main thread.
+    mutable GDC_PerfStats perf_stats;
+    bool monitors_registered = false; // only the first world in the tree registers
+    String trace_path;
+    Ref<FileAccess> trace_file;
 };
 
-}  // namespace godot
\ No newline at end of file
+}  // namespace godot
+
+VARIANT_ENUM_CAST(GDC_World::Monitor);
\ No newline at end of file